@@ -13,17 +13,24 @@ const CONFIG = {
     retryDelay: 1000,
     logRefreshInterval: 5000,
     connectionTimeout: 10000,
+    idleTimeout: 15 * 60 * 1000, // Bu süre etkileşim yoksa sekme boşta sayılır
+    idlePollInterval: 60000,     // Boştaki sekmelerin yoklama aralığı
     theme: {
         key: 'teias-theme',
         default: 'light'
     }
 };
 
-let updateTimer = null;
 let logTimer = null;
 let connectionRetries = 0;
 let isPageVisible = true;
 let currentTheme = 'light';
+let statusVersion = 0; // Sunucudaki durum görüntüsünün bilinen son sürümü
+let statusSnapshot = {}; // Değişikliklerle birleştirilmiş tam durum (diğer sekmelere bu gider)
+let liveSocket = null;
+let liveRetryTimer = null;
+let liveRetryDelay = 1000;
+let viewCleanups = []; // Görünümden çıkarken çalışacaklar (zamanlayıcılar, akışlar)
 
 // ===================================
 // UTILITY FUNCTIONS
@@ -256,7 +263,8 @@ async function apiRequest(url, options = {}) {
             
             clearTimeout(timeoutId);
             
-            if (!response.ok) {
+            // 304: sunucuda değişiklik yok, gövde boş
+            if (!response.ok && response.status !== 304) {
                 throw new Error(`HTTP ${response.status}: ${response.statusText}`);
             }
             
@@ -296,51 +304,474 @@ function updateConnectionStatus(isConnected, errorMessage = '') {
 }
 
 // ===================================
-// DASHBOARD DATA MANAGEMENT
+// LIVE SOCKET
 // ===================================
 
 /**
- * Update dashboard data
+ * Open the multiplexed WebSocket and subscribe to topics.
+ * handlers: { topic: (data) => {} }; 'resync' lists topics to refetch over HTTP.
  */
-async function updateDashboardData() {
+function openLiveSocket(topics, handlers) {
+    if (!('WebSocket' in window) || liveSocket) return;
+    
+    const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
+    const socket = new WebSocket(`${protocol}//${window.location.host}/ws`);
+    liveSocket = socket;
+    
+    socket.onopen = () => {
+        liveRetryDelay = 1000;
+        socket.send('sub:' + topics.join(','));
+        updateConnectionStatus(true);
+    };
+    
+    socket.onmessage = (event) => {
+        let msg;
+        try {
+            msg = JSON.parse(event.data);
+        } catch (error) {
+            return;
+        }
+        // Oturum sona erdi (çıkış ya da zaman aşımı): yeniden bağlanılmaz
+        if (msg.t === 'ended') {
+            closeLiveSocket();
+            window.location.href = '/login';
+            return;
+        }
+        const handler = handlers[msg.t];
+        if (handler) handler(msg.d);
+    };
+    
+    socket.onclose = () => {
+        if (liveSocket === socket) liveSocket = null;
+        // Sayfa açıksa artan aralıklarla yeniden bağlan; bu sırada HTTP yoklaması devrede
+        if (isPageVisible && !liveRetryTimer) {
+            liveRetryTimer = setTimeout(() => {
+                liveRetryTimer = null;
+                openLiveSocket(topics, handlers);
+            }, liveRetryDelay);
+            liveRetryDelay = Math.min(liveRetryDelay * 2, 30000);
+        }
+    };
+}
+
+/**
+ * Close the live socket (page hidden / leaving)
+ */
+function closeLiveSocket() {
+    if (liveRetryTimer) {
+        clearTimeout(liveRetryTimer);
+        liveRetryTimer = null;
+    }
+    if (liveSocket) {
+        const socket = liveSocket;
+        liveSocket = null;
+        socket.close();
+    }
+}
+
+/**
+ * True while pushed updates are flowing
+ */
+function isLiveSocketOpen() {
+    return liveSocket !== null && liveSocket.readyState === WebSocket.OPEN;
+}
+
+// ===================================
+// POLL SCHEDULER
+// ===================================
+// Tüm yoklamalar tek bir tikte toplanır; sekme gizliyken tik tamamen durur.
+// Açık sekmeler BroadcastChannel üzerinden bir lider seçer: paylaşılan
+// beslemeleri (durum) yalnızca lider çeker ve diğer sekmelere dağıtır.
+
+const POLL_TICK_MS = 1000;
+const POLL_HEARTBEAT_MS = 2000;
+const POLL_PEER_TIMEOUT_MS = 5000;
+
+// En eski sekme lider olur: kimlik açılış zamanıyla başlar
+const pollTabId = Date.now().toString(36) + Math.random().toString(36).slice(2, 8);
+
+const localPollers = new Map();      // ad -> { interval, fn, due, busy, idleThrottle }
+const sharedFeeds = new Map();       // ad -> { interval, fn, start, stop, mode, due, busy }
+const sharedSubscribers = new Map(); // ad -> Set(handler)
+const sharedLast = new Map();        // ad -> son dağıtılan veri
+const pollPeers = new Map();         // sekme kimliği -> { demand, idle, seen }
+let pollTimer = null;
+let pollKickTimer = null;
+let pollChannel = null;
+let lastPollAnnounce = 0;
+let lastInteraction = Date.now();
+
+/**
+ * Register a poller for this tab; returns a function that removes it.
+ * Runs every interval ms while the tab is visible (throttled when idle).
+ */
+function schedulePoll(name, interval, fn, { idleThrottle = true } = {}) {
+    const poller = { interval, fn, due: Date.now() + interval, busy: false, idleThrottle };
+    localPollers.set(name, poller);
+    startPollScheduler();
+    return () => {
+        if (localPollers.get(name) === poller) localPollers.delete(name);
+    };
+}
+
+/**
+ * Define a feed shared by all tabs; only the leader runs it.
+ * start()/stop() bracket live mode (e.g. a push socket), fn() is the poll.
+ */
+function defineSharedFeed(name, { interval, fn, start, stop }) {
+    sharedFeeds.set(name, { interval, fn, start, stop, mode: 'off', due: 0, busy: false });
+}
+
+/**
+ * Subscribe to a shared feed; returns a function that unsubscribes
+ */
+function subscribeShared(name, handler) {
+    if (!sharedSubscribers.has(name)) sharedSubscribers.set(name, new Set());
+    sharedSubscribers.get(name).add(handler);
+    if (sharedLast.has(name)) handler(sharedLast.get(name));
+    
+    startPollScheduler();
+    announcePollState();
+    kickPollTick();
+    return () => {
+        sharedSubscribers.get(name)?.delete(handler);
+        announcePollState();
+    };
+}
+
+/**
+ * Hand feed data to this tab's subscribers
+ */
+function deliverShared(name, data) {
+    sharedLast.set(name, data);
+    sharedSubscribers.get(name)?.forEach(handler => handler(data));
+}
+
+/**
+ * Leader side: deliver locally and to every other tab
+ */
+function publishShared(name, data) {
+    deliverShared(name, data);
+    if (pollChannel) pollChannel.postMessage({ type: 'data', name, data });
+}
+
+/**
+ * Shared feeds this tab currently needs
+ */
+function localPollDemand() {
+    const names = [];
+    sharedSubscribers.forEach((handlers, name) => {
+        if (handlers.size > 0) names.push(name);
+    });
+    return names;
+}
+
+/**
+ * No user input for CONFIG.idleTimeout (e.g. a forgotten control-room screen)
+ */
+function isTabIdle() {
+    return Date.now() - lastInteraction > CONFIG.idleTimeout;
+}
+
+/**
+ * Feed mode across all tabs: 'off' (unused), 'idle' (only idle tabs) or 'live'
+ */
+function sharedFeedMode(name) {
+    let mode = 'off';
+    const note = (idle) => {
+        if (!idle) mode = 'live';
+        else if (mode === 'off') mode = 'idle';
+    };
+    
+    if (localPollDemand().includes(name)) note(isTabIdle());
+    pollPeers.forEach(peer => {
+        if (peer.demand.includes(name)) note(peer.idle);
+    });
+    return mode;
+}
+
+/**
+ * Visible tab with the smallest id leads; hidden tabs never do
+ */
+function isPollLeader() {
+    if (!isPageVisible) return false;
+    for (const id of pollPeers.keys()) {
+        if (id < pollTabId) return false;
+    }
+    return true;
+}
+
+/**
+ * Heartbeat: tell the other tabs we are here and what we need
+ */
+function announcePollState() {
+    lastPollAnnounce = Date.now();
+    if (!pollChannel || !isPageVisible) return;
+    pollChannel.postMessage({ type: 'hello', id: pollTabId, demand: localPollDemand(), idle: isTabIdle() });
+}
+
+/**
+ * Messages from the other tabs
+ */
+function handlePollMessage(event) {
+    const msg = event.data || {};
+    
+    if (msg.type === 'hello') {
+        const previous = pollPeers.get(msg.id);
+        const demand = Array.isArray(msg.demand) ? msg.demand : [];
+        pollPeers.set(msg.id, { demand, idle: !!msg.idle, seen: Date.now() });
+        
+        // Yeni ihtiyaç: itilen veri değişmedikçe gelmez, lider sonuncuyu hemen yollar
+        if (isPollLeader()) {
+            demand.forEach(name => {
+                const feed = sharedFeeds.get(name);
+                if (previous?.demand.includes(name) || !feed || feed.mode === 'off') return;
+                if (sharedLast.has(name)) {
+                    pollChannel.postMessage({ type: 'data', name, data: sharedLast.get(name) });
+                }
+            });
+        }
+        // Yeni sekme de bizi beklemeden tanısın
+        if (!previous) announcePollState();
+    } else if (msg.type === 'leave') {
+        pollPeers.delete(msg.id);
+        kickPollTick();
+    } else if (msg.type === 'data' && typeof msg.name === 'string') {
+        deliverShared(msg.name, msg.data);
+    }
+}
+
+/**
+ * Run a poller if it is due; a slow request is never overlapped
+ */
+function runDuePoller(poller, now, idle) {
+    if (poller.busy || now < poller.due) return;
+    
+    poller.due = now + (idle ? Math.max(poller.interval, CONFIG.idlePollInterval) : poller.interval);
+    poller.busy = true;
+    Promise.resolve()
+        .then(() => poller.fn())
+        .catch(error => console.warn('Poll failed:', error))
+        .finally(() => {
+            poller.busy = false;
+        });
+}
+
+/**
+ * Single scheduler tick: heartbeat, shared feeds (leader only), local pollers
+ */
+function pollTick() {
     if (!isPageVisible) return;
+    const now = Date.now();
     
+    pollPeers.forEach((peer, id) => {
+        if (now - peer.seen > POLL_PEER_TIMEOUT_MS) pollPeers.delete(id);
+    });
+    if (now - lastPollAnnounce >= POLL_HEARTBEAT_MS) announcePollState();
+    
+    const leader = isPollLeader();
+    sharedFeeds.forEach((feed, name) => {
+        const mode = leader ? sharedFeedMode(name) : 'off';
+        if (mode !== feed.mode) {
+            if (feed.mode === 'live' && feed.stop) feed.stop();
+            if (mode === 'live' && feed.start) feed.start();
+            feed.mode = mode;
+            feed.due = now;
+        }
+        if (mode !== 'off') runDuePoller(feed, now, mode === 'idle');
+    });
+    
+    const idle = isTabIdle();
+    localPollers.forEach(poller => runDuePoller(poller, now, idle && poller.idleThrottle));
+}
+
+/**
+ * Run a tick shortly, after the other tabs had a chance to answer
+ */
+function kickPollTick() {
+    if (pollKickTimer || !pollTimer) return;
+    pollKickTimer = setTimeout(() => {
+        pollKickTimer = null;
+        pollTick();
+    }, 200);
+}
+
+/**
+ * Start (or resume) the scheduler while the tab is visible
+ */
+function startPollScheduler() {
+    if (pollTimer || !isPageVisible) return;
+    
+    if (!pollChannel && 'BroadcastChannel' in window) {
+        pollChannel = new BroadcastChannel('teias-poll');
+        pollChannel.onmessage = handlePollMessage;
+    }
+    
+    announcePollState();
+    pollTimer = setInterval(pollTick, POLL_TICK_MS);
+    kickPollTick();
+}
+
+/**
+ * Pause everything: leadership passes to another visible tab at once
+ */
+function pausePollScheduler() {
+    if (pollTimer) {
+        clearInterval(pollTimer);
+        pollTimer = null;
+    }
+    if (pollKickTimer) {
+        clearTimeout(pollKickTimer);
+        pollKickTimer = null;
+    }
+    
+    sharedFeeds.forEach(feed => {
+        if (feed.mode === 'live' && feed.stop) feed.stop();
+        feed.mode = 'off';
+    });
+    pollPeers.clear();
+    if (pollChannel) pollChannel.postMessage({ type: 'leave', id: pollTabId });
+}
+
+/**
+ * Any user input ends the idle state
+ */
+function noteInteraction() {
+    const wasIdle = isTabIdle();
+    lastInteraction = Date.now();
+    if (wasIdle) {
+        announcePollState();
+        kickPollTick();
+    }
+}
+
+/**
+ * Define the shared feeds and start scheduling
+ */
+function initializePollScheduler() {
+    ['pointerdown', 'keydown', 'wheel', 'touchstart'].forEach(type => {
+        document.addEventListener(type, noteInteraction, { passive: true });
+    });
+    
+    // Durum: canlıyken WebSocket ile itilir, soket yokken/boştayken HTTP ile yoklanır
+    defineSharedFeed('status', {
+        interval: CONFIG.updateInterval,
+        fn: () => {
+            if (!isLiveSocketOpen()) return updateDashboardData();
+        },
+        start: () => openLiveSocket(['status'], {
+            status: (data) => {
+                mergeStatus(data);
+                publishShared('status', statusSnapshot);
+            },
+            resync: () => updateDashboardData()
+        }),
+        stop: closeLiveSocket
+    });
+    
+    startPollScheduler();
+}
+
+// ===================================
+// DASHBOARD DATA MANAGEMENT
+// ===================================
+
+/**
+ * Merge a status delta into the full snapshot
+ */
+function mergeStatus(data) {
+    Object.assign(statusSnapshot, data);
+    statusVersion = data.version || statusVersion;
+}
+
+/**
+ * Fetch status changes and share the snapshot (leader tab)
+ */
+async function updateDashboardData() {
     try {
-        const response = await apiRequest('/api/status');
-        const data = await response.json();
-        
-        if (!data || typeof data !== 'object') {
-            throw new Error('Invalid API response format');
+        // Yalnızca bilinen sürümden sonra değişen alanlar gelir
+        const response = await apiRequest(`/api/status?since=${statusVersion}`);
+        if (response.status !== 304) {
+            const data = await response.json();
+            
+            if (!data || typeof data !== 'object') {
+                throw new Error('Invalid API response format');
+            }
+            
+            mergeStatus(data);
         }
-        
-        updateDashboardElements(data);
-        updateLastUpdateTime();
+        publishShared('status', statusSnapshot);
         
     } catch (error) {
         console.error('Dashboard update failed:', error);
-        showDashboardError();
+        // Bağlantı dönünce tam görüntü istensin
+        statusVersion = 0;
+        publishShared('status', null);
     }
 }
 
+// Sunucunun durum kodlarından rozet metni ve türü
+const STATUS_BADGES = {
+    ethernet: {
+        up: ['✅ Bağlı', 'success'],
+        down: ['❌ Bağlantı Yok', 'error']
+    },
+    ntpConfig: {
+        configured: ['✅ Yapılandırıldı', 'success'],
+        default: ['⚠️ Varsayılan', 'warning']
+    },
+    backend: {
+        active: ['✅ Aktif', 'success'],
+        lost: ['❌ Veri Alınamıyor', 'error']
+    }
+};
+
 /**
- * Update dashboard DOM elements
+ * Badge HTML for a status code
+ */
+function statusCodeBadge(group, code) {
+    const badge = STATUS_BADGES[group][code];
+    return badge ? createStatusBadge(badge[0], badge[1]) : createStatusBadge(null);
+}
+
+/**
+ * Human readable uptime from seconds
+ */
+function formatUptime(totalSeconds) {
+    const days = Math.floor(totalSeconds / 86400);
+    const hours = Math.floor((totalSeconds % 86400) / 3600);
+    const minutes = Math.floor((totalSeconds % 3600) / 60);
+    const seconds = totalSeconds % 60;
+    
+    let uptime = '';
+    if (days > 0) uptime += `${days} gün, `;
+    if (hours > 0) uptime += `${hours} saat, `;
+    if (minutes > 0) uptime += `${minutes} dk, `;
+    return uptime + `${seconds} sn`;
+}
+
+/**
+ * Update dashboard DOM elements (only the fields present in the delta)
  */
 function updateDashboardElements(data) {
-    const updates = {
-        'datetime': data.datetime || 'Bilinmiyor',
-        'dataStatus': createStatusBadge(data.backendStatus, 'info'),
-        'deviceName': data.deviceName || 'Tanımsız',
-        'tmName': data.tmName || 'Tanımsız',
-        'deviceIP': data.deviceIP || '0.0.0.0',
-        'uptime': data.uptime || '0',
-        'ethernetStatus': createStatusBadge(data.ethernetStatus, 'success'),
-        'ntpConfigStatus': createStatusBadge(data.ntpConfigStatus, 'info'),
-        'backendStatus': createStatusBadge(data.backendStatus, 'warning'),
-        'baudRate': (data.baudRate || 0) + ' bps'
-    };
+    const updates = {};
+    
+    if ('datetime' in data) updates.datetime = data.datetime || 'Zaman verisi bekleniyor...';
+    if ('deviceName' in data) updates.deviceName = data.deviceName || 'Tanımsız';
+    if ('tmName' in data) updates.tmName = data.tmName || 'Tanımsız';
+    if ('deviceIP' in data) updates.deviceIP = data.deviceIP || '0.0.0.0';
+    if ('uptime' in data) updates.uptime = formatUptime(data.uptime || 0);
+    if ('baudRate' in data) updates.baudRate = (data.baudRate || 0) + ' bps';
+    if ('ethernet' in data) updates.ethernetStatus = statusCodeBadge('ethernet', data.ethernet);
+    if ('ntpConfig' in data) updates.ntpConfigStatus = statusCodeBadge('ntpConfig', data.ntpConfig);
+    if ('backend' in data) {
+        updates.dataStatus = statusCodeBadge('backend', data.backend);
+        updates.backendStatus = updates.dataStatus;
+    }
     
     Object.entries(updates).forEach(([id, value]) => {
-        safeUpdateElement(id, value, true);
+        // Rozetler dışındaki değerler metin olarak yazılır
+        safeUpdateElement(id, value, id.endsWith('Status'));
     });
 }
 
@@ -473,6 +904,9 @@ async function handleFormSubmission(formId, apiUrl, successMessage, validationFn
                 showMessage(successMessage, 'success');
                 
                 // Handle special cases
+                if (formId === 'ntpForm') {
+                    watchNtpPush();
+                }
                 if (formId === 'accountForm' && formData.get('password')) {
                     setTimeout(() => {
                         if (confirm('Şifreniz değiştirildi. Tekrar giriş yapmanız gerekiyor.')) {
@@ -511,7 +945,7 @@ function initializeLoginPage() {
         safeUpdateElement('currentTime', new Date().toLocaleTimeString('tr-TR'));
     };
     updateTime();
-    setInterval(updateTime, 1000);
+    schedulePoll('clock', 1000, updateTime, { idleThrottle: false });
     
     // Handle login form
     loginForm.addEventListener('submit', async (event) => {
@@ -657,7 +1091,7 @@ function initializeNtpPage() {
     handleFormSubmission(
         'ntpForm', 
         '/api/ntp', 
-        'NTP ayarları başarıyla arka porta gönderildi!'
+        'NTP ayarları kaydedildi, arka porta gönderiliyor...'
     );
     
     // Preset server buttons
@@ -685,7 +1119,31 @@ function initializeNtpPage() {
 }
 
 /**
- * Load NTP settings
+ * Human readable backend push status
+ */
+function formatNtpPushStatus(status, attempts) {
+    switch (status) {
+        case 'pending': return `⏳ Bekleniyor (deneme ${attempts || 0})`;
+        case 'acked':   return '✅ Onaylandı';
+        case 'nacked':  return '❌ Reddedildi';
+        case 'timeout': return `⚠️ Yanıt yok (${attempts} deneme)`;
+        default:        return 'Gönderilmedi';
+    }
+}
+
+/**
+ * Poll the backend push status after saving until it settles
+ */
+function watchNtpPush(remaining = 40) {
+    setTimeout(async () => {
+        const data = await loadNtpStatus();
+        if (!data || data.pushStatus !== 'pending' || remaining <= 1) return;
+        watchNtpPush(remaining - 1);
+    }, 1500);
+}
+
+/**
+ * Load NTP settings (ETag'li; değişmediyse tarayıcı önbelleğinden gelir)
  */
 async function loadNtpSettings() {
     try {
@@ -697,6 +1155,8 @@ async function loadNtpSettings() {
         safeUpdateElement('currentServer1', data.ntpServer1 || 'Tanımsız');
         safeUpdateElement('currentServer2', data.ntpServer2 || 'Tanımsız');
         safeUpdateElement('lastUpdate', formatTimestamp());
+        await loadNtpStatus();
+        return data;
         
     } catch (error) {
         console.error('Failed to load NTP settings:', error);
@@ -704,6 +1164,22 @@ async function loadNtpSettings() {
     }
 }
 
+/**
+ * Load live NTP state (backend push, sync)
+ */
+async function loadNtpStatus() {
+    try {
+        const response = await apiRequest('/api/ntp/status');
+        const data = await response.json();
+        
+        safeUpdateElement('pushStatus', formatNtpPushStatus(data.pushStatus, data.pushAttempts));
+        return data;
+        
+    } catch (error) {
+        console.error('Failed to load NTP status:', error);
+    }
+}
+
 /**
  * Test NTP connection
  */
@@ -891,7 +1367,7 @@ function initializeFaultPage() {
     
     let faultData = [];
     let autoRefreshEnabled = false;
-    let autoRefreshTimer = null;
+    let stopAutoRefresh = null;
     
     // Event listeners
     if (firstBtn) {
@@ -1090,14 +1566,12 @@ function initializeFaultPage() {
         toggle.querySelector('.toggle-icon').textContent = autoRefreshEnabled ? '⏸️' : '▶️';
         
         if (autoRefreshEnabled) {
-            autoRefreshTimer = setInterval(() => {
-                fetchFaultData('/api/faults/refresh');
-            }, 10000); // 10 saniyede bir
+            stopAutoRefresh = schedulePoll('faults', 10000, () => fetchFaultData('/api/faults/refresh')); // 10 saniyede bir
             showMessage('Otomatik yenileme açıldı.', 'info');
         } else {
-            if (autoRefreshTimer) {
-                clearInterval(autoRefreshTimer);
-                autoRefreshTimer = null;
+            if (stopAutoRefresh) {
+                stopAutoRefresh();
+                stopAutoRefresh = null;
             }
             showMessage('Otomatik yenileme kapatıldı.', 'info');
         }
@@ -1112,6 +1586,14 @@ function initializeFaultPage() {
         showMessage(`${filteredCount} kayıt gösteriliyor.`, 'info', 2000);
     }
     
+    // Görünümden çıkınca otomatik yenileme durur
+    onViewLeave(() => {
+        if (stopAutoRefresh) {
+            stopAutoRefresh();
+            stopAutoRefresh = null;
+        }
+    });
+    
     // Initialize fault stats
     updateFaultStats();
 }
@@ -1129,8 +1611,13 @@ function initializeLogPage() {
     const clearBtn = safeQuerySelector('#clearLogsBtn');
     
     let logData = [];
+    let logCursor = 0;
+    let logEpoch = null;
+    const MAX_CLIENT_LOGS = 500;
     let isLogPaused = false;
-    let logRefreshTimer = null;
+    let stopLogPoll = null;
+    let logStream = null;
+    let renderPending = false;
     let autoScrollEnabled = true;
     
     // Event listeners
@@ -1191,17 +1678,37 @@ function initializeLogPage() {
     }
     
     /**
-     * Fetch logs from API
+     * Fetch new logs from API (cursor based)
      */
     async function fetchLogs() {
         try {
-            const response = await apiRequest('/api/logs');
-            const logs = await response.json();
+            let hasMore = true;
+            let changed = false;
             
-            if (Array.isArray(logs)) {
-                logData = logs;
+            while (hasMore) {
+                const response = await apiRequest(`/api/logs?since=${logCursor}`);
+                if (response.status === 304) break;
+                
+                const result = await response.json();
+                if (!result || !Array.isArray(result.entries)) break;
+                
+                // Loglar temizlendiyse veya cihaz yeniden başladıysa listeyi sıfırla
+                if (result.epoch !== logEpoch || result.cursor < logCursor) {
+                    logData = [];
+                    logEpoch = result.epoch;
+                }
+                
+                appendLogEntries(result.entries);
+                logCursor = result.cursor;
+                hasMore = result.more === true;
+                changed = true;
+            }
+            
+            if (changed) {
                 updateLogDisplay();
                 updateLogStats();
+            } else {
+                safeUpdateElement('lastLogUpdate', formatTimestamp());
             }
             
         } catch (error) {
@@ -1210,6 +1717,87 @@ function initializeLogPage() {
         }
     }
     
+    /**
+     * Append entries to the local list, keeping it bounded
+     */
+    function appendLogEntries(entries) {
+        logData.push(...entries);
+        if (logData.length > MAX_CLIENT_LOGS) {
+            logData.splice(0, logData.length - MAX_CLIENT_LOGS);
+        }
+    }
+    
+    /**
+     * Coalesce display updates when entries arrive in bursts
+     */
+    function scheduleLogRender() {
+        if (renderPending) return;
+        renderPending = true;
+        setTimeout(() => {
+            renderPending = false;
+            updateLogDisplay();
+            updateLogStats();
+        }, 200);
+    }
+    
+    /**
+     * Start live log stream (Server-Sent Events)
+     */
+    function startLogStream() {
+        stopLogStream();
+        
+        // EventSource yoksa periyodik sorguya dön
+        if (!window.EventSource) {
+            startLogRefresh();
+            return;
+        }
+        
+        logStream = new EventSource(`/api/logs/stream?since=${logCursor}`);
+        
+        logStream.addEventListener('log', (event) => {
+            try {
+                const entry = JSON.parse(event.data);
+                if (entry.seq <= logCursor) return;
+                appendLogEntries([entry]);
+                logCursor = entry.seq;
+                scheduleLogRender();
+            } catch (error) {
+                console.warn('Invalid log event:', error);
+            }
+        });
+        
+        // Loglar temizlendi veya cihaz yeniden başladı
+        logStream.addEventListener('reset', () => {
+            logData = [];
+            logCursor = 0;
+            logEpoch = null;
+            fetchLogs();
+        });
+        
+        // Oturum sona erdi (çıkış ya da zaman aşımı): yeniden bağlanılmaz
+        logStream.addEventListener('ended', () => {
+            stopLogStream();
+            window.location.href = '/login';
+        });
+        
+        logStream.addEventListener('dropped', (event) => {
+            console.warn(`Yavaş bağlantı nedeniyle ${event.data} log kaydı atlandı.`);
+        });
+        
+        logStream.onopen = () => updateConnectionStatus(true);
+        logStream.onerror = () => updateConnectionStatus(false, 'Canlı log bağlantısı kesildi');
+    }
+    
+    /**
+     * Stop live log stream
+     */
+    function stopLogStream() {
+        if (logStream) {
+            logStream.close();
+            logStream = null;
+        }
+    }
+    
     /**
      * Update log display
      */
@@ -1278,7 +1866,7 @@ function initializeLogPage() {
             filtered = filtered.filter(log => log.source === sourceValue);
         }
         
-        return filtered.reverse(); // Show newest first
+        return filtered; // En eski önce, en yeni altta
     }
     
     /**
@@ -1349,6 +1937,13 @@ function initializeLogPage() {
             btn.className = isLogPaused ? 'btn success' : 'btn warning';
         }
         
+        if (isLogPaused) {
+            stopLogStream();
+            stopLogRefresh();
+        } else if (autoRefreshToggle?.dataset.active === 'true') {
+            startLogStream();
+        }
+        
         showMessage(isLogPaused ? 'Log güncellemesi duraklatıldı.' : 'Log güncellemesi devam ediyor.', 'info');
     }
     
@@ -1408,8 +2003,9 @@ function initializeLogPage() {
         autoRefreshToggle.querySelector('.toggle-icon').textContent = newState ? '⏸️' : '▶️';
         
         if (newState && !isLogPaused) {
-            startLogRefresh();
+            startLogStream();
         } else {
+            stopLogStream();
             stopLogRefresh();
         }
     }
@@ -1418,46 +2014,46 @@ function initializeLogPage() {
      * Update refresh interval
      */
     function updateRefreshInterval() {
-        if (logRefreshTimer) {
+        if (stopLogPoll) {
             stopLogRefresh();
             startLogRefresh();
         }
     }
     
     /**
-     * Start log refresh timer
+     * Start log refresh timer (fallback when EventSource is unavailable)
      */
     function startLogRefresh() {
-        if (logRefreshTimer) clearInterval(logRefreshTimer);
+        stopLogRefresh();
         
         const interval = parseInt(refreshInterval?.value || CONFIG.logRefreshInterval);
-        logRefreshTimer = setInterval(() => {
-            if (!isLogPaused && isPageVisible) {
-                fetchLogs();
-            }
-        }, interval);
+        stopLogPoll = schedulePoll('logs', interval, () => {
+            if (!isLogPaused) return fetchLogs();
+        });
     }
     
     /**
      * Stop log refresh timer
      */
     function stopLogRefresh() {
-        if (logRefreshTimer) {
-            clearInterval(logRefreshTimer);
-            logRefreshTimer = null;
+        if (stopLogPoll) {
+            stopLogPoll();
+            stopLogPoll = null;
         }
     }
     
-    // Initialize logs
-    fetchLogs();
-    
-    // Start auto refresh if enabled
-    if (autoRefreshToggle?.dataset.active === 'true') {
-        startLogRefresh();
-    }
+    // Initialize logs, then follow new entries over the live stream
+    fetchLogs().then(() => {
+        if (autoRefreshToggle?.dataset.active === 'true') {
+            startLogStream();
+        }
+    });
     
-    // Cleanup on page unload
-    window.addEventListener('beforeunload', stopLogRefresh);
+    // Cleanup when the view is left (or the page unloads)
+    onViewLeave(() => {
+        stopLogStream();
+        stopLogRefresh();
+    });
 }
 
 // ===================================
@@ -1471,41 +2067,126 @@ function handleVisibilityChange() {
     isPageVisible = !document.hidden;
     
     if (isPageVisible) {
-        // Resume updates when page becomes visible
-        if (window.location.pathname === '/') {
-            startDashboardUpdates();
-        }
+        // Resume polling; leadership is settled again with the other tabs
+        lastInteraction = Date.now();
+        startPollScheduler();
     } else {
-        // Pause updates when page is hidden
-        stopDashboardUpdates();
+        // Gizli sekme hiç istek atmaz, liderlik görünür bir sekmeye geçer
+        pausePollScheduler();
     }
 }
 
 /**
- * Start dashboard updates
+ * Initialize dashboard view
  */
-function startDashboardUpdates() {
-    if (updateTimer) clearInterval(updateTimer);
-    
-    // Initial update
-    updateDashboardData();
-    
-    // Set up periodic updates
-    updateTimer = setInterval(() => {
-        if (isPageVisible) {
-            updateDashboardData();
+function initializeDashboardView() {
+    // Durum lider sekmeden gelir (tek sekmede lider bu sekmedir)
+    const unsubscribe = subscribeShared('status', (data) => {
+        if (!data) {
+            showDashboardError();
+            updateConnectionStatus(false);
+            return;
         }
-    }, CONFIG.updateInterval);
+        updateDashboardElements(data);
+        updateLastUpdateTime();
+        updateConnectionStatus(true);
+    });
+    onViewLeave(unsubscribe);
 }
 
+// ===================================
+// VIEW ROUTING
+// ===================================
+
+// Kabuk sayfasındaki görünümler (/app.html, tools/embed_assets.py üretir)
+const VIEW_INITIALIZERS = {
+    '/': initializeDashboardView,
+    '/ntp': initializeNtpPage,
+    '/baudrate': initializeBaudRatePage,
+    '/fault': initializeFaultPage,
+    '/account': initializeAccountPage,
+    '/log': initializeLogPage
+};
+
 /**
- * Stop dashboard updates
+ * Register a function to run when the current view is left
  */
-function stopDashboardUpdates() {
-    if (updateTimer) {
-        clearInterval(updateTimer);
-        updateTimer = null;
+function onViewLeave(fn) {
+    viewCleanups.push(fn);
+}
+
+/**
+ * Run and clear the current view's cleanups
+ */
+function leaveView() {
+    const pending = viewCleanups;
+    viewCleanups = [];
+    pending.forEach(fn => {
+        try {
+            fn();
+        } catch (error) {
+            console.warn('View cleanup failed:', error);
+        }
+    });
+}
+
+/**
+ * Is this page the single-page shell with view templates
+ */
+function isShellPage() {
+    return !!document.getElementById('view-root');
+}
+
+/**
+ * Render the view for a path from its template
+ */
+function renderView(path) {
+    const template = document.querySelector(`template[data-view="${path}"]`);
+    const root = document.getElementById('view-root');
+    if (!template || !root || !VIEW_INITIALIZERS[path]) return false;
+    
+    leaveView();
+    root.replaceChildren(template.content.cloneNode(true));
+    document.title = template.dataset.title || document.title;
+    highlightActivePage();
+    window.scrollTo(0, 0);
+    VIEW_INITIALIZERS[path]();
+    return true;
+}
+
+/**
+ * Navigate to a view; in the shell this costs no page load
+ */
+function navigateTo(path) {
+    if (!isShellPage() || !VIEW_INITIALIZERS[path]) {
+        window.location.href = path;
+        return;
     }
+    if (path === window.location.pathname) return;
+    
+    history.pushState({}, '', path);
+    if (!renderView(path)) window.location.href = path;
+}
+
+/**
+ * Route same-origin view links and history navigation inside the shell
+ */
+function initializeViewRouting() {
+    document.addEventListener('click', (e) => {
+        if (e.defaultPrevented || e.button !== 0 || e.ctrlKey || e.metaKey || e.shiftKey || e.altKey) return;
+        
+        const link = e.target.closest('a[href]');
+        if (!link || link.target || link.origin !== window.location.origin) return;
+        if (!VIEW_INITIALIZERS[link.pathname]) return;
+        
+        e.preventDefault();
+        navigateTo(link.pathname);
+    });
+    
+    // Geri/ileri: adres çubuğu zaten değişti, yalnızca görünüm çizilir
+    window.addEventListener('popstate', () => {
+        if (!renderView(window.location.pathname)) window.location.reload();
+    });
 }
 
 // ===================================
@@ -1553,27 +2234,27 @@ function setupKeyboardShortcuts() {
             switch (e.key) {
                 case '1':
                     e.preventDefault();
-                    window.location.href = '/';
+                    navigateTo('/');
                     break;
                 case '2':
                     e.preventDefault();
-                    window.location.href = '/ntp';
+                    navigateTo('/ntp');
                     break;
                 case '3':
                     e.preventDefault();
-                    window.location.href = '/baudrate';
+                    navigateTo('/baudrate');
                     break;
                 case '4':
                     e.preventDefault();
-                    window.location.href = '/fault';
+                    navigateTo('/fault');
                     break;
                 case '5':
                     e.preventDefault();
-                    window.location.href = '/account';
+                    navigateTo('/account');
                     break;
                 case '6':
                     e.preventDefault();
-                    window.location.href = '/log';
+                    navigateTo('/log');
                     break;
                 case 't':
                 case 'T':
@@ -1682,11 +2363,24 @@ function initializeApp() {
     monitorPerformance();
     
     // Page visibility handling
+    isPageVisible = !document.hidden;
     document.addEventListener('visibilitychange', handleVisibilityChange);
     
+    // Shared poll scheduler (one leader tab talks to the device)
+    initializePollScheduler();
+    
     // Initialize page-specific functionality
     const currentPath = window.location.pathname;
     
+    // Kabuk: görünüm adres çubuğundaki yoldan seçilir, sonraki geçişler sayfa yüklemez
+    if (isShellPage()) {
+        initializeViewRouting();
+        if (!renderView(currentPath)) renderView('/');
+        console.log('✅ TEİAŞ EKLİM Web Arayüzü başarıyla başlatıldı.');
+        return;
+    }
+    
+    // Ayrı sayfalar: giriş sayfası ve gzip desteklemeyen istemciler
     switch (currentPath) {
         case '/login':
             initializeLoginPage();
@@ -1716,7 +2410,7 @@ function initializeApp() {
         default:
             // Dashboard page
             if (currentPath !== '/login') {
-                startDashboardUpdates();
+                initializeDashboardView();
             }
             break;
     }
@@ -1728,7 +2422,8 @@ function initializeApp() {
  * Cleanup function
  */
 function cleanup() {
-    stopDashboardUpdates();
+    leaveView();
+    pausePollScheduler();
     
     if (logTimer) {
         clearInterval(logTimer);
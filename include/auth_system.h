@@ -2,11 +2,32 @@
 #define AUTH_SYSTEM_H
 
 #include <Arduino.h>
+#include <ESPAsyncWebServer.h>
 
-bool checkSession();
-void handleUserLogin();
-void handleUserLogout();
-void refreshSession();
+#define AUTH_MAX_SESSIONS 8             // Aynı anda açık en fazla oturum
+#define AUTH_SESSION_BUCKETS 16         // Oturum tablosu (2'nin kuvveti, en az 2 x oturum)
+#define AUTH_TOKEN_BYTES 16             // 128 bit rastgele anahtar
+#define AUTH_COOKIE_NAME "EKLIM_SID"
+#define AUTH_REFRESH_INTERVAL_MS 60000  // Doğrulanan istek oturum süresini en fazla bu sıklıkla yeniler
 
-#endif
+// Açılıştan beri oturum olayları
+struct AuthStats {
+    uint32_t loginSuccess;
+    uint32_t loginFailure;
+    uint32_t lockouts;
+    uint32_t logouts;
+    uint32_t timeouts;
+    uint32_t evictions;     // Tablo dolu: en uzun süredir görülmeyen oturum kapatıldı
+};
+
+bool checkSession(AsyncWebServerRequest* request);
+uint32_t getSessionId(AsyncWebServerRequest* request);  // 0: geçerli oturum yok
+bool isSessionActive(uint32_t sessionId);
+bool refreshSession(AsyncWebServerRequest* request);
+void endAllSessions();
+int getActiveSessionCount();
+void handleUserLogin(AsyncWebServerRequest* request);
+void handleUserLogout(AsyncWebServerRequest* request);
+const AuthStats& getAuthStats();
 
+#endif
@@ -0,0 +1,32 @@
+#ifndef CRASH_LOG_H
+#define CRASH_LOG_H
+
+#include <Arduino.h>
+#include "log_system.h"
+
+// RTC no-init bellekte tutulan kayıt sayısı ve alan boyutları
+#define CRASH_LOG_CAPACITY 32
+#define CRASH_LOG_SOURCE_LEN 8
+#define CRASH_LOG_MESSAGE_LEN 72
+#define CRASH_LOG_REASON_LEN 24
+
+struct CrashLogRecord {
+    uint32_t millis_time;
+    uint8_t level;
+    char source[CRASH_LOG_SOURCE_LEN];
+    char message[CRASH_LOG_MESSAGE_LEN];
+};
+
+void initCrashLog();
+void importCrashLog();
+void crashLogRecord(const String& msg, LogLevel level, const String& source);
+void crashLogNoteRestart(const char* reason);
+
+// Önceki açılışa ait anlık görüntü
+int getCrashLogCount();
+const CrashLogRecord* getCrashLogRecord(int index);
+const char* getResetReasonString();
+const char* getPreviousRestartNote();
+uint32_t getBootCount();
+
+#endif
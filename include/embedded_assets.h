@@ -0,0 +1,21 @@
+#ifndef EMBEDDED_ASSETS_H
+#define EMBEDDED_ASSETS_H
+
+#include <Arduino.h>
+
+// Flash'a gömülü, gzip'li web dosyası (tools/embed_assets.py üretir)
+struct EmbeddedAsset {
+    const char* path;
+    const char* contentType;
+    const uint8_t* data;      // gzip'li içerik, doğrudan flash'tan okunur
+    size_t length;
+    const char* etag;         // İçerik özeti, tırnaklarla birlikte
+    bool immutable;           // ?v=<özet> ile sürümlenen dosya
+};
+
+extern const EmbeddedAsset embeddedAssets[];
+extern const size_t embeddedAssetCount;
+
+const EmbeddedAsset* findEmbeddedAsset(const String& path);
+
+#endif
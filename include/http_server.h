@@ -0,0 +1,77 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+#include <functional>
+#include "json_arena.h"
+#include "rate_limiter.h"
+
+#ifndef HTTP_MAX_CONNECTIONS
+#define HTTP_MAX_CONNECTIONS 8          // Aynı anda işlenen en fazla istek (PSRAM varken)
+#endif
+#ifndef HTTP_FALLBACK_CONNECTIONS
+#define HTTP_FALLBACK_CONNECTIONS 4     // PSRAM yoksa
+#endif
+#define HTTP_BUFFER_SIZE 4096           // Bağlantı başına yanıt tamponu
+#define HTTP_ARENA_SIZE 4096            // Bağlantı başına JSON belge bölgesi
+#define HTTP_LARGE_BUFFER_SIZE 16384    // Yuvaya sığmayan tek yanıt için ortak tampon (PSRAM yoksa yarısı)
+#define HTTP_MAX_DEFERRED 4             // loop()'a ertelenebilecek en fazla istek
+#define HTTP_STREAM_ITEM_SIZE 768       // Akış yanıtında tek öğenin en büyük boyutu
+#define HTTP_STREAM_ARENA_SIZE 1536     // Tek öğelik belge bölgesi (ArduinoJson havuzu 1 KB)
+#define HTTP_STREAM_HEAD_SIZE 384       // Akış yanıtında dizi öncesi alanların en büyük boyutu
+
+typedef void (*HttpHandler)(AsyncWebServerRequest* request);
+
+struct JsonStream;
+
+// Bir isteğe bağlantı süresince ayrılan havuz yuvası
+struct HttpSlot {
+    AsyncWebServerRequest* request;     // nullptr: boş
+    char* buffer;
+    size_t size;
+    JsonArena arena;                    // İsteğin JsonDocument'ları buradan ayrılır
+    int holds;                          // Bağlantı kapansa da bölgeyi kullanan iş/yanıt sayısı
+    uint32_t bytes;                     // Yanıt gövdesi (rota ölçümü için)
+    uint32_t startedUs;                 // İsteğin gelişi (micros)
+    uint32_t handlerUs;                 // İşleyici süresi; ertelenen işte sonuç hazır olana kadar
+    JsonStream* stream;                 // Akış yanıtı durumu (buffer içinde kurulur)
+};
+
+// Bloklayan iş: loop() içinde çalışır, HTTP kodu döndürüp yanıt belgesini doldurur
+typedef std::function<int(JsonDocument& doc)> DeferredWork;
+
+// Akış yanıtı öğe kaynağı: index'inci öğeyi item'a yazar, öğe kalmadıysa false döner.
+// Öğe artık yoksa (ör. log kaydının üzerine yazıldı) item boş bırakılır ve atlanır.
+typedef std::function<bool(size_t index, JsonDocument& item)> JsonItemSource;
+
+bool initHttpServer();
+void addRoute(const char* uri, WebRequestMethodComposite method, HttpHandler handler, uint16_t cost = RATE_COST_READ);
+void addNotFoundRoute(HttpHandler handler, uint16_t cost = RATE_COST_READ);
+HttpSlot* getHttpSlot(AsyncWebServerRequest* request);
+ArduinoJson::Allocator* getJsonAllocator(AsyncWebServerRequest* request);
+void* allocateRequestMemory(AsyncWebServerRequest* request, size_t size);
+
+// Yanıt yardımcıları
+void addSecurityHeaders(AsyncWebServerResponse* response);
+void countResponseBytes(AsyncWebServerRequest* request, size_t bytes);
+bool wantsMsgPack(AsyncWebServerRequest* request);
+void sendJson(AsyncWebServerRequest* request, int code, JsonDocument& doc, const char* etag = nullptr);
+void sendJsonStream(AsyncWebServerRequest* request, JsonDocument& head, const char* arrayKey, JsonItemSource source);
+void sendJsonText(AsyncWebServerRequest* request, int code, const char* json);
+void sendJsonError(AsyncWebServerRequest* request, int code, const char* message);
+void sendRedirect(AsyncWebServerRequest* request, const char* location, const char* setCookie = nullptr);
+bool sendNotModified(AsyncWebServerRequest* request, const char* etag);
+
+bool deferRequest(AsyncWebServerRequest* request, DeferredWork work);
+void runDeferredRequests();
+
+int getHttpActiveConnections();
+int getHttpPeakConnections();
+int getHttpPoolSize();
+uint32_t getHttpRejectedCount();
+size_t getHttpArenaPeak();
+uint32_t getHttpArenaOverflows();
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Önceden ayrılmış bellek üzerinde sıralı (bump) ayırıcı. Belgeler isteğe ait
+// bölgeden yer alır, istek bitince bölge tek seferde sıfırlanır; genel heap
+// parçalanmaz. Bölge dolarsa ayırma başarısız olur (belge overflowed() döner) ve
+// sayılır; malloc'a düşmek yalnızca heapFallback ile açıkça istenirse yapılır.
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    void begin(uint8_t* memory, size_t size, bool heapFallback = false);
+    void reset();
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    size_t used() const { return offset; }
+    size_t peak() const { return peakUsed; }
+    size_t capacity() const { return size; }
+    uint32_t overflows() const { return overflowCount; }
+
+private:
+    bool owns(const void* ptr) const;
+
+    uint8_t* memory = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    size_t lastOffset = SIZE_MAX;   // Son bloğun başı (yerinde büyütme/geri alma için)
+    size_t peakUsed = 0;
+    uint32_t overflowCount = 0;
+    bool heapFallback = false;
+};
+
+#endif
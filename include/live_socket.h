@@ -0,0 +1,29 @@
+#ifndef LIVE_SOCKET_H
+#define LIVE_SOCKET_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+#define LIVE_SOCKET_MAX_CLIENTS 4
+#define LIVE_MESSAGE_SIZE 768           // Tek mesajın en büyük boyutu
+#define LIVE_LOG_BATCH 4                // loop() başına yayınlanan en fazla log kaydı
+#define LIVE_LOG_MAX_BACKLOG 24         // Daha gerisi atlanır, istemciye resync bildirilir
+#define LIVE_HANDOFF_MS 5000            // Filtreden geçip bağlanmayan isteğin kaydı bu süre sonra silinir
+
+// Abone olunabilen konular (bit maskesi)
+enum LiveTopic : uint8_t {
+    LIVE_TOPIC_TIME = 0x01,
+    LIVE_TOPIC_STATUS = 0x02,
+    LIVE_TOPIC_LOG = 0x04,
+    LIVE_TOPIC_FAULT = 0x08,
+    LIVE_TOPIC_UART = 0x10
+};
+
+void setupLiveSocket();
+void handleLiveSocketAPI(AsyncWebServerRequest* request);
+void pumpLiveSocket();
+void publishFaultEvent(const String& response, bool isFirst);
+int getLiveSocketClientCount();
+uint32_t getLiveSocketDroppedCount();
+
+#endif
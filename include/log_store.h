@@ -0,0 +1,68 @@
+#ifndef LOG_STORE_H
+#define LOG_STORE_H
+
+#include <Arduino.h>
+#include "log_system.h"
+
+// Kapasite build_flags ile değiştirilebilir (-DLOG_STORE_CAPACITY=...)
+#ifndef LOG_STORE_CAPACITY
+#define LOG_STORE_CAPACITY 20000         // PSRAM varsa
+#endif
+#ifndef LOG_STORE_FALLBACK_CAPACITY
+#define LOG_STORE_FALLBACK_CAPACITY 128  // PSRAM yoksa iç RAM
+#endif
+
+#define LOG_STORE_MESSAGE_LEN 100
+#define LOG_STORE_SOURCE_LEN 12
+#define LOG_STORE_MAX_SOURCES 24
+// Zaman indeksi: 1024 kova x 10 dk ≈ 7 gün; seyrek loglarda da dolu deponun tamamını kapsar
+#define LOG_STORE_BUCKET_SECONDS 600
+#define LOG_STORE_BUCKETS 1024
+#define LOG_LEVEL_COUNT 5
+
+// 128 byte'lık sabit boyutlu kayıt
+struct LogRecord {
+    uint32_t seq;
+    uint32_t millis_time;
+    uint32_t uptime;          // Açılıştan beri saniye (taşmaz)
+    uint32_t wallTime;        // UTC epoch saniye, 0 = bilinmiyor
+    uint32_t prevSameLevel;   // Aynı seviyedeki önceki kaydın seq'i
+    uint32_t prevSameSource;  // Aynı kaynaktaki önceki kaydın seq'i
+    uint8_t level;
+    uint8_t sourceId;
+    uint8_t length;
+    char message[LOG_STORE_MESSAGE_LEN];
+};
+
+struct LogQuery {
+    uint32_t sinceSeq;    // Bu seq'ten sonrakiler, en eskiden başlayarak (0 = yok)
+    uint32_t beforeSeq;   // Bu seq'ten öncekiler (0 = sınırsız)
+    uint32_t fromUptime;  // Uptime aralığı, saniye (0 = sınırsız)
+    uint32_t toUptime;
+    int level;            // -1 = tümü
+    int sourceId;         // -1 = tümü
+    int limit;
+};
+
+bool initLogStore();
+uint32_t logStoreAppend(const String& msg, LogLevel level, const String& source);
+void logStoreClear();
+const LogRecord* logStoreGet(uint32_t seq);
+int logStoreQuery(const LogQuery& query, uint32_t* out, bool* more);
+
+uint32_t logStoreNewestSeq();
+uint32_t logStoreOldestSeq();
+uint32_t logStoreCount();
+uint32_t logStoreCapacity();
+uint32_t logStoreEpoch();
+uint32_t logStoreLevelTotal(LogLevel level);
+bool logStoreInPsram();
+
+// Web sunucusu ayrı görevde çalışır: kayıt işaretçileri kilit tutulurken kullanılmalı
+void logStoreLock();
+void logStoreUnlock();
+
+int logStoreFindSource(const String& name);
+const char* logStoreSourceName(uint8_t id);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef LOG_STREAM_H
+#define LOG_STREAM_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "log_store.h"
+
+#define LOG_STREAM_MAX_CLIENTS 3
+#define LOG_STREAM_BUFFER_SIZE 512     // Tek olayın JSON tamponu
+#define LOG_STREAM_MAX_BACKLOG 24      // Kütüphanenin istemci kuyruğunu (32 mesaj) taşırmaz
+#define LOG_STREAM_MAX_QUEUED 8        // İstemci kuyruğunda bekleyen mesaj sınırı (aşan istemci o tur atlanır)
+#define LOG_STREAM_BATCH 4             // loop() başına en fazla kayıt
+#define LOG_STREAM_HEARTBEAT_MS 15000
+#define LOG_STREAM_RETRY_MS 3000
+#define LOG_STREAM_HANDOFF_MS 5000     // Filtreden geçip bağlanmayan isteğin kaydı bu süre sonra silinir
+
+void setupLogStream();
+void handleLogStreamAPI(AsyncWebServerRequest* request);
+void pumpLogStreams();
+int getLogStreamClientCount();
+
+// Kaydın JSON hali (SSE ve WebSocket ortak); log deposu kilitliyken çağrılmalı
+size_t formatLogRecordJson(const LogRecord& rec, char* out, size_t size);
+
+#endif
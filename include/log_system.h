@@ -11,23 +11,23 @@ enum LogLevel {
     SUCCESS = 4
 };
 
-struct LogEntry {
-    String timestamp;
-    String message;
-    LogLevel level;
-    String source;
-    unsigned long millis_time;
-};
-
-extern LogEntry logs[50];
-extern int logIndex;
-extern int totalLogs;
-
 void initLogSystem();
 void addLog(const String& msg, LogLevel level, const String& source);
 String logLevelToString(LogLevel level);
+const char* logLevelName(LogLevel level);
+bool logLevelFromString(const String& str, LogLevel& level);
 void clearLogs();
 String getFormattedTimestamp();
 String getFormattedTimestampFallback();
 
+#define LOG_TIMESTAMP_LEN 24        // "GG.AA.YYYY SS:DD:ss" + sonlandırıcı
+
+// Zaman damgaları çağıranın tamponuna yazılır: loop() ve web sunucusu görevi aynı anda çağırabilir
+void formatLogTimestamp(uint32_t wallTime, uint32_t millisTime, char* out, size_t size);
+
+// Saniyede bir formatlanan önbellekten kopyalanır; saat ayarlıysa true döner
+bool getCachedTimestamp(char* out, size_t size);   // Tarih ve saat, saat ayarlı değilse uptime
+bool getCachedDate(char* out, size_t size);        // Saat ayarlı değilse boş
+bool getCachedTime(char* out, size_t size);
+
 #endif
\ No newline at end of file
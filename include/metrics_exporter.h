@@ -0,0 +1,13 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// Prometheus metin biçimi (text/plain; version=0.0.4). Çıktı metrik grubu grubu
+// isteğin yuva tamponunda üretilip chunked gönderilir; tam metin hiç tutulmaz.
+#define METRICS_PREFIX "eklim_"
+
+void handlePrometheusMetrics(AsyncWebServerRequest* request);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef METRICS_HISTORY_H
+#define METRICS_HISTORY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Sağlık değerlerinin zaman serisi: 5 sn, 1 dk ve 1 sa çözünürlüklü sabit halkalar.
+// Üst katman, alt katmana her örnek eklendiğinde biriktirilerek üretilir.
+#define HISTORY_5S_SIZE 120             // 10 dakika
+#define HISTORY_1M_SIZE 120             // 2 saat
+#define HISTORY_1H_SIZE 168             // 7 gün
+#define HISTORY_NO_DATA 0xFF            // Yüzde alanında: pencerede ölçüm yok
+
+enum HistoryTier {
+    HISTORY_TIER_5S = 0,
+    HISTORY_TIER_1M,
+    HISTORY_TIER_1H,
+    HISTORY_TIER_COUNT
+};
+
+struct HistorySample {
+    uint16_t heapKB;            // Penceredeki en düşük boş heap
+    uint16_t blockKB;           // Penceredeki en küçük en büyük blok
+    uint16_t loopAvgUs;
+    uint16_t loopMaxMs;
+    uint16_t framesPerMin;      // Arka port tarih/saat kareleri
+    uint8_t uartPct;            // Başarılı UART komutu yüzdesi
+    uint8_t linkPct;            // Ethernet bağlantısının açık olduğu örnek yüzdesi
+};
+
+void noteLoopTime(uint32_t durationUs);
+void sampleMetricsHistory();    // checkSystemHealth() içinden, 5 sn'de bir
+
+bool historyTierFromString(const String& name, HistoryTier& tier);
+const char* historyTierName(HistoryTier tier);
+uint16_t getHistoryInterval(HistoryTier tier);     // sn
+uint32_t getHistorySeq(HistoryTier tier);          // Katmana eklenen toplam örnek
+uint32_t getHistoryNewestUptime(HistoryTier tier); // Son örneğin zamanı (sn)
+uint16_t getHistorySize(HistoryTier tier);
+bool getHistorySample(HistoryTier tier, uint32_t seq, HistorySample& out);
+void writeHistorySample(const HistorySample& sample, JsonArray out);
+
+#endif
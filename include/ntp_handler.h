@@ -3,13 +3,51 @@
 
 #include <Arduino.h>
 
+// Arka porttan çözülen son tarih ve saat (sıkıştırılmış)
 struct ReceivedTimeData {
-    String date;
-    String time;
-    bool isValid;
+    uint8_t day;
+    uint8_t month;
+    uint8_t year;         // 2000'den itibaren
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    bool hasDate;
+    bool isValid;         // Geçerli saat karesi alındı
     unsigned long lastUpdate;
 };
 
+// Hatalı kare türleri
+enum FrameError {
+    FRAME_ERR_LENGTH = 0,
+    FRAME_ERR_DIGIT,      // Rakam olmayan karakter
+    FRAME_ERR_RANGE,      // Gün/ay/saat aralık dışı
+    FRAME_ERR_CHECK,      // Tanınmayan kontrol karakteri
+    FRAME_ERR_OVERFLOW,   // Satır tampon boyutunu aştı
+    FRAME_ERR_COUNT
+};
+
+struct BackendFrameStats {
+    uint32_t dateFrames;
+    uint32_t timeFrames;
+    uint32_t replies;     // ACK/NACK satırları
+    uint32_t errors[FRAME_ERR_COUNT];
+};
+
+// Arka porta NTP ayarı gönderiminin durumu
+enum NTPPushStatus {
+    NTP_PUSH_IDLE = 0,
+    NTP_PUSH_PENDING,     // Gönderildi veya yeniden deneme bekliyor
+    NTP_PUSH_ACKED,
+    NTP_PUSH_NACKED,
+    NTP_PUSH_TIMEOUT      // Tüm denemeler yanıtsız kaldı
+};
+
+#define NTP_PUSH_BOOT_DELAY_MS 1000     // Açılışta backend'in hazır olması için
+#define NTP_PUSH_ACK_TIMEOUT_MS 3000
+#define NTP_PUSH_MAX_ATTEMPTS 5
+#define NTP_PUSH_BACKOFF_BASE_MS 2000   // Her denemede ikiye katlanır
+#define NTP_PUSH_BACKOFF_MAX_MS 60000
+
 struct NTPConfig {
     char ntpServer1[64];
     char ntpServer2[64];
@@ -26,9 +64,13 @@ void processReceivedData();
 bool loadNTPSettings();
 bool saveNTPSettings(const String& server1, const String& server2, int timezone);
 void sendNTPConfigToBackend();
-String formatDate(const String& dateStr);
-String formatTime(const String& timeStr);
-void parseTimeData(const String& data);
+void processNTPPush();
+NTPPushStatus getNTPPushStatus();
+const char* ntpPushStatusToString(NTPPushStatus status);
+int getNTPPushAttempts();
+void parseTimeData(const char* frame, size_t length);
+const BackendFrameStats& getBackendFrameStats();
+const char* frameErrorToString(FrameError error);
 void readBackendData();
 bool isTimeDataValid();
 String getCurrentDateTime();
@@ -0,0 +1,25 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+
+// İstemci (IP) başına token kovası. Kova dolu başlar, saniyede sabit miktarda dolar;
+// her rota kendi maliyeti kadar token harcar.
+#define RATE_TABLE_SIZE 16              // İzlenen en fazla istemci (LRU ile çıkarılır)
+#define RATE_BUCKET_CAPACITY 60         // Ani istek payı (token)
+#define RATE_REFILL_PER_SEC 5           // Sürekli hız (token/sn)
+
+// Rota maliyetleri
+#define RATE_COST_FREE 0                // Statik dosyalar
+#define RATE_COST_CACHED 1              // Hazır veriden okuma (durum, loglar)
+#define RATE_COST_READ 2                // Ayar okuma
+#define RATE_COST_WRITE 6               // Flash'a yazan işlemler
+#define RATE_COST_UART 10               // İşlemciyle UART üzerinden konuşan işlemler
+
+// Yeterli token varsa harcar; yoksa false döner ve bekleme süresini (sn) yazar
+bool rateLimitTake(uint32_t clientIP, uint16_t cost, uint32_t* retryAfterSec);
+
+uint32_t getRateLimitedCount();
+int getRateLimitClientCount();
+
+#endif
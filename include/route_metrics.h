@@ -0,0 +1,38 @@
+#ifndef ROUTE_METRICS_H
+#define ROUTE_METRICS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Rota başına istek sayısı, durum kodu sınıfları, gönderilen bayt ve gecikme
+// histogramı. Gecikme isteğin gelişinden bağlantının kapanmasına kadardır
+// (ertelenen ve akışla gönderilen yanıtlar dahil). İşleyici süresi ayrıca tutulur:
+// gelişten yanıtın kuyruğa verilmesine kadar (ertelenen işte sonuç hazır olana kadar).
+#define ROUTE_METRICS_MAX 40            // İzlenen en fazla rota
+#define ROUTE_LATENCY_BUCKETS 10        // Son kova: en büyük sınırın üstü
+#define ROUTE_SLOWEST_COUNT 8           // Saklanan en yavaş istek sayısı
+#define ROUTE_SLOWEST_URI_LEN 48
+
+struct RouteMetrics {
+    const char* uri;
+    const char* method;
+    uint32_t count;
+    uint32_t status[5];                 // 2xx, 3xx, 4xx, 5xx, yanıtsız kapanan
+    uint64_t bytes;
+    uint64_t totalUs;
+    uint32_t maxUs;
+    uint64_t handlerTotalUs;
+    uint32_t handlerMaxUs;
+    uint32_t buckets[ROUTE_LATENCY_BUCKETS];
+};
+
+// Rota tablosuna ekler; tablo doluysa -1 (rota ölçülmez)
+int registerRouteMetrics(const char* uri, const char* method);
+void recordRouteRequest(int route, const String& url, int status, uint32_t bytes, uint32_t durationUs, uint32_t handlerUs);
+void writeRouteMetrics(JsonDocument& doc);
+bool writeRouteMetricsItem(size_t index, JsonDocument& item);  // "routes" akış öğesi
+int getRouteMetricsCount();
+void copyRouteMetrics(int route, RouteMetrics& out);
+uint16_t getRouteBucketLimitMs(int bucket);    // Son kova için 0 (sınırsız)
+
+#endif
@@ -2,7 +2,7 @@
 #define SETTINGS_H
 
 #include <Arduino.h>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 #include <ETH.h>
 
 struct Settings {
@@ -16,16 +16,27 @@ struct Settings {
     String passwordSalt;
     String passwordHash;
     long currentBaudRate;
-    bool isLoggedIn;
-    unsigned long sessionStartTime;
-    unsigned long SESSION_TIMEOUT;
+    unsigned long SESSION_TIMEOUT;      // Oturum başına etkinliksiz geçebilecek süre
 };
 
-extern WebServer server;
+// Yapılandırma alanları: her kayıtta nesli artar, GET yanıtlarının ETag'i buradan üretilir
+enum ConfigDomain {
+    CONFIG_SETTINGS = 0,
+    CONFIG_NTP,
+    CONFIG_BAUDRATE,
+    CONFIG_SYSTEM,              // Açılışta sabit (donanım bilgisi)
+    CONFIG_DOMAIN_COUNT
+};
+
+extern AsyncWebServer server;
 extern Settings settings;
 
 void loadSettings();
 bool saveSettings(const String& newDevName, const String& newTmName, const String& newUsername, const String& newPassword);
 void initEthernet();
 
+void bumpConfigGeneration(ConfigDomain domain);
+uint32_t getConfigGeneration(ConfigDomain domain);
+void formatConfigETag(ConfigDomain domain, char* out, size_t size);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef SNTP_CLIENT_H
+#define SNTP_CLIENT_H
+
+#include <Arduino.h>
+
+#define SNTP_DEFAULT_PORT 123
+#define SNTP_LOCAL_PORT 12300
+#define SNTP_STARTUP_GRACE_MS 30000     // Açılışta arka port verisi için bekleme
+#define SNTP_POLL_INTERVAL_MS 64000     // Başarılı sorgular arası
+#define SNTP_RETRY_INTERVAL_MS 15000    // Başarısız tur sonrası
+#define SNTP_SAMPLES 4                  // Tur başına örnek sayısı
+#define SNTP_REPLY_TIMEOUT_MS 1000
+#define SNTP_DNS_TIMEOUT_MS 5000
+
+enum SntpState {
+    SNTP_STATE_IDLE = 0,      // Arka port aktif, SNTP beklemede
+    SNTP_STATE_WAITING,       // Sıradaki tur için bekliyor
+    SNTP_STATE_RESOLVING,
+    SNTP_STATE_QUERYING
+};
+
+void processSntpClient();
+bool isSntpActive();
+const char* getSntpStateString();
+const char* getSntpServer();
+uint32_t getSntpSuccessCount();
+uint32_t getSntpFailureCount();
+int32_t getSntpLastDelayMs();
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Gösterge paneli alanları; her birinin değiştiği sürüm ayrı tutulur
+enum StatusField {
+    STATUS_FIELD_DATETIME = 0,
+    STATUS_FIELD_UPTIME,
+    STATUS_FIELD_DEVICE_NAME,
+    STATUS_FIELD_TM_NAME,
+    STATUS_FIELD_DEVICE_IP,
+    STATUS_FIELD_BAUD_RATE,
+    STATUS_FIELD_FREE_HEAP,
+    STATUS_FIELD_CHIP_MODEL,
+    STATUS_FIELD_CPU_FREQ,
+    STATUS_FIELD_ETHERNET,
+    STATUS_FIELD_NTP_CONFIG,
+    STATUS_FIELD_BACKEND,
+    STATUS_FIELD_COUNT
+};
+
+#define STATUS_HEAP_STEP 1024           // Boş heap bu kadar değişmedikçe yeni sürüm yok
+
+void initStatusSnapshot();
+void updateStatusSnapshot();            // loop(): saniyede bir saat/uptime/heap/arka port
+
+// Alt sistemler değer gerçekten değiştiğinde çağırır
+void statusSetDevice(const String& deviceName, const String& tmName, IPAddress ip);
+void statusSetBaudRate(long baudRate);
+void statusSetEthernet(bool linkUp);
+void statusSetNtpConfigured(bool configured);
+
+uint32_t getStatusVersion();
+// since sürümünden sonra değişen alanları yazar (since = 0 ya da başka açılışın sürümü: tümü)
+void writeStatusSnapshot(JsonDocument& doc, uint32_t since);
+
+#endif
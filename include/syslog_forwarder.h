@@ -0,0 +1,28 @@
+#ifndef SYSLOG_FORWARDER_H
+#define SYSLOG_FORWARDER_H
+
+#include <Arduino.h>
+
+#define SYSLOG_DEFAULT_PORT 514
+#define SYSLOG_MAX_DATAGRAM 1200      // MTU altında kal
+#define SYSLOG_BATCH_RECORDS 8        // Datagram başına en fazla kayıt
+#define SYSLOG_FLUSH_MS 500           // Eksik paketin en fazla bekleme süresi
+#define SYSLOG_MAX_BACKLOG 256        // Gönderilmeyi bekleyen en fazla kayıt
+#define SYSLOG_RECORDS_PER_LOOP 8
+
+struct SyslogConfig {
+    char host[16];   // IPv4 adresi
+    uint16_t port;
+    bool enabled;
+};
+
+extern SyslogConfig syslogConfig;
+
+void initSyslog();
+void processSyslog();
+bool saveSyslogSettings(const String& host, int port, bool enabled);
+uint32_t getSyslogSentCount();
+uint32_t getSyslogDroppedCount();
+uint32_t getSyslogBacklog();
+
+#endif
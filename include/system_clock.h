@@ -0,0 +1,38 @@
+#ifndef SYSTEM_CLOCK_H
+#define SYSTEM_CLOCK_H
+
+#include <Arduino.h>
+#include <time.h>
+
+enum ClockSource {
+    CLOCK_SOURCE_NONE = 0,
+    CLOCK_SOURCE_BACKEND = 1,
+    CLOCK_SOURCE_SNTP = 2
+};
+
+#define CLOCK_STEP_THRESHOLD_MS 2000    // Bundan büyük hatada saat atlatılır
+#define CLOCK_HOLDOVER_MS 3600000UL     // Referanssız en fazla 1 saat geçerli sayılır
+#define CLOCK_FREQ_WINDOW_MS 600000UL   // Sürüklenme ölçüm penceresi (10 dk)
+#define CLOCK_MAX_DRIFT_PPM 500
+#define CLOCK_SLEW_WINDOW_MS 8000       // Faz hatası bu sürede hız ayarıyla eritilir
+#define CLOCK_MAX_SLEW_PPM 50000        // Geçici hız ayarı sınırı (%5, pencere başına 400 ms)
+#define CLOCK_BACKWARD_CONFIRM_FRAMES 5 // Geri atlama için art arda tutarlı kare sayısı
+#define CLOCK_BACKWARD_AGREE_MS 500     // Bu karelerin farkları arasındaki en büyük sapma
+#define CLOCK_REBASE_MS 86400000UL      // Taban en geç günde bir öne alınır (millis() taşması)
+
+void initSystemClock(int timezoneHours);
+void setClockTimezone(int timezoneHours);
+void disciplineClock(uint64_t utcMillis, unsigned long atMillis, ClockSource source);
+void resyncClock();
+bool isClockSynced();
+uint64_t getClockMillis();
+time_t getClockTime();
+bool getClockLocalTime(struct tm* out);
+int getClockTimezone();
+int32_t getClockDriftPpm();
+int32_t getClockLastOffsetMs();
+ClockSource getClockSource();
+unsigned long getClockLastSyncMillis();
+int64_t daysFromCivil(int year, unsigned month, unsigned day);
+
+#endif
@@ -3,6 +3,15 @@
 
 #include <Arduino.h>
 
+// UART istatistikleri
+struct UARTStats {
+    unsigned long totalCommands;
+    unsigned long successfulCommands;
+    unsigned long failedCommands;
+    unsigned long lastSuccessTime;
+    unsigned long lastFailTime;
+};
+
 void initUART();
 bool changeBaudRate(long newBaudRate); // Return type düzeltildi: void -> bool
 bool requestFirstFault();
@@ -16,5 +25,8 @@ void updateUARTStats(bool success);
 String getUARTStatus();
 bool sendCustomCommand(const String& command, String& response, unsigned long timeout = 0);
 bool testUARTConnection();
+const UARTStats& getUARTStats();
+bool isUARTHealthy();
+int getUARTErrorCount();
 
 #endif
\ No newline at end of file
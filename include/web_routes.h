@@ -2,25 +2,30 @@
 #define WEB_ROUTES_H
 
 #include <Arduino.h>
+#include <ESPAsyncWebServer.h>
 
 void setupWebRoutes();
-void serveStaticFile(const String& path, const String& contentType);
-String getUptime();
-void addSecurityHeaders();
-bool checkRateLimit();
+void serveStaticFile(AsyncWebServerRequest* request, const String& path, const String& contentType);
 
 // API Handler fonksiyonları
-void handleStatusAPI();
-void handleGetSettingsAPI();
-void handlePostSettingsAPI();
-void handleFaultRequest(bool isFirst);
-void handleGetNtpAPI();
-void handlePostNtpAPI();
-void handleGetBaudRateAPI();
-void handlePostBaudRateAPI();
-void handleGetLogsAPI();
-void handleClearLogsAPI();
-void handleSystemInfoAPI();
-void handleSessionRefresh();
+void handleStatusAPI(AsyncWebServerRequest* request);
+void handleGetSettingsAPI(AsyncWebServerRequest* request);
+void handlePostSettingsAPI(AsyncWebServerRequest* request);
+void handleFaultRequest(AsyncWebServerRequest* request, bool isFirst);
+void handleGetNtpAPI(AsyncWebServerRequest* request);
+void handleGetNtpStatusAPI(AsyncWebServerRequest* request);
+void handlePostNtpAPI(AsyncWebServerRequest* request);
+void handleGetBaudRateAPI(AsyncWebServerRequest* request);
+void handlePostBaudRateAPI(AsyncWebServerRequest* request);
+void handleGetLogsAPI(AsyncWebServerRequest* request);
+void handleClearLogsAPI(AsyncWebServerRequest* request);
+void handleCrashLogAPI(AsyncWebServerRequest* request);
+void handleGetSyslogAPI(AsyncWebServerRequest* request);
+void handlePostSyslogAPI(AsyncWebServerRequest* request);
+void handleSystemInfoAPI(AsyncWebServerRequest* request);
+void handleSystemMemoryAPI(AsyncWebServerRequest* request);
+void handleMetricsAPI(AsyncWebServerRequest* request);
+void handleMetricsHistoryAPI(AsyncWebServerRequest* request);
+void handleSessionRefresh(AsyncWebServerRequest* request);
 
 #endif
\ No newline at end of file
@@ -2,10 +2,9 @@
 #include "settings.h"
 #include "log_system.h"
 #include "crypto_utils.h"
-#include <WebServer.h>
+#include "http_server.h"
 
 extern Settings settings;
-extern WebServer server;
 
 // Giriş denemesi sayacı ve kilitlenme sistemi
 static int loginAttempts = 0;
@@ -13,85 +12,312 @@ static unsigned long lockoutTime = 0;
 const int MAX_LOGIN_ATTEMPTS = 5;
 const unsigned long LOCKOUT_DURATION = 300000; // 5 dakika (300 saniye)
 
-bool checkSession() {
-    if (!settings.isLoggedIn) return false;
-    if (millis() - settings.sessionStartTime > settings.SESSION_TIMEOUT) {
-        settings.isLoggedIn = false;
-        addLog("Oturum zaman aşımı.", INFO, "AUTH");
-        return false;
+static AuthStats authStats = {0, 0, 0, 0, 0, 0};
+
+// Oturum tablosu: anahtarın ilk baytları doğrudan kova numarasıdır. Oturum açılırken
+// boş bir kovaya düşen anahtar seçildiği için çakışma olmaz; her istek tek kova ve
+// tek sabit süreli karşılaştırma ile doğrulanır. Süresi dolanlar bakıldıkça temizlenir.
+struct AuthSession {
+    uint8_t token[AUTH_TOKEN_BYTES];
+    uint32_t id;                    // 0: boş; alt bitler kova numarası
+    unsigned long refreshedAt;      // Süre buradan sayılır (doğrulanan istekler, dakikada bir)
+    unsigned long lastSeen;         // Son doğrulanan istek
+};
+
+static AuthSession sessions[AUTH_SESSION_BUCKETS];
+static int sessionCount = 0;
+static uint32_t nextSerial = 1;
+static portMUX_TYPE sessionMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t bucketOf(const uint8_t* token) {
+    uint32_t hash = (uint32_t)token[0] | (uint32_t)token[1] << 8 | (uint32_t)token[2] << 16 | (uint32_t)token[3] << 24;
+    return hash & (AUTH_SESSION_BUCKETS - 1);
+}
+
+// Eşleşmeyen baytın yeri süreye yansımasın
+static bool tokensEqual(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    for (int i = 0; i < AUTH_TOKEN_BYTES; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Cookie başlığından oturum anahtarı (String kopyası yok)
+static bool readToken(AsyncWebServerRequest* request, uint8_t* token) {
+    if (!request->hasHeader("Cookie")) return false;
+    const String& cookies = request->header("Cookie");
+    const char* start = cookies.c_str();
+    const char* p = strstr(start, AUTH_COOKIE_NAME "=");
+    // Adı bizimkiyle biten başka bir çerez değil
+    while (p && p != start && p[-1] != ' ' && p[-1] != ';') {
+        p = strstr(p + 1, AUTH_COOKIE_NAME "=");
+    }
+    if (!p) return false;
+
+    p += sizeof(AUTH_COOKIE_NAME);
+    for (int i = 0; i < AUTH_TOKEN_BYTES; i++) {
+        int hi = hexValue(p[i * 2]);
+        if (hi < 0) return false;
+        int lo = hexValue(p[i * 2 + 1]);
+        if (lo < 0) return false;
+        token[i] = (uint8_t)(hi << 4 | lo);
     }
     return true;
 }
 
+// Kilit altında çağrılır
+static bool isExpired(const AuthSession& s, unsigned long now) {
+    return now - s.refreshedAt > settings.SESSION_TIMEOUT;
+}
+
+static void releaseSession(AuthSession& s) {
+    memset(s.token, 0, sizeof(s.token));
+    s.id = 0;
+    sessionCount--;
+}
+
+// Kilit altında çağrılır; süresi dolanları boşaltır
+static int sweepExpired(unsigned long now) {
+    int expired = 0;
+    for (int i = 0; i < AUTH_SESSION_BUCKETS; i++) {
+        if (sessions[i].id != 0 && isExpired(sessions[i], now)) {
+            releaseSession(sessions[i]);
+            expired++;
+        }
+    }
+    authStats.timeouts += expired;
+    return expired;
+}
+
+static void logTimeouts(int expired) {
+    if (expired > 0) {
+        addLog("Oturum zaman aşımı (" + String(expired) + ").", INFO, "AUTH");
+    }
+}
+
+// Çerezdeki anahtarın oturumu. Her doğrulanan istek etkinliktir: süre en fazla
+// AUTH_REFRESH_INTERVAL_MS'de bir baştan başlar; refresh: hemen baştan başlar.
+static uint32_t lookupSession(AsyncWebServerRequest* request, bool refresh) {
+    uint8_t token[AUTH_TOKEN_BYTES];
+    if (!readToken(request, token)) return 0;
+
+    AuthSession& s = sessions[bucketOf(token)];
+    unsigned long now = millis();
+    uint32_t id = 0;
+    int expired = 0;
+
+    portENTER_CRITICAL(&sessionMux);
+    if (s.id != 0 && tokensEqual(s.token, token)) {
+        if (isExpired(s, now)) {
+            releaseSession(s);
+            authStats.timeouts++;
+            expired = 1;
+        } else {
+            s.lastSeen = now;
+            if (refresh || now - s.refreshedAt >= AUTH_REFRESH_INTERVAL_MS) s.refreshedAt = now;
+            id = s.id;
+        }
+    }
+    portEXIT_CRITICAL(&sessionMux);
+
+    logTimeouts(expired);
+    return id;
+}
+
+// Yeni oturum: tablo doluysa en uzun süredir görülmeyen kapatılır
+static uint32_t createSession(uint8_t* token, bool& evicted) {
+    unsigned long now = millis();
+    evicted = false;
+
+    portENTER_CRITICAL(&sessionMux);
+    int expired = sweepExpired(now);
+    if (sessionCount >= AUTH_MAX_SESSIONS) {
+        int oldest = -1;
+        for (int i = 0; i < AUTH_SESSION_BUCKETS; i++) {
+            if (sessions[i].id == 0) continue;
+            if (oldest < 0 || now - sessions[i].lastSeen > now - sessions[oldest].lastSeen) oldest = i;
+        }
+        releaseSession(sessions[oldest]);
+        authStats.evictions++;
+        evicted = true;
+    }
+
+    // Tablonun en az yarısı boş: beklenen deneme sayısı ikiden az
+    uint32_t bucket;
+    do {
+        for (int i = 0; i < AUTH_TOKEN_BYTES; i += 4) {
+            uint32_t r = esp_random();
+            memcpy(token + i, &r, 4);
+        }
+        bucket = bucketOf(token);
+    } while (sessions[bucket].id != 0);
+
+    AuthSession& s = sessions[bucket];
+    memcpy(s.token, token, AUTH_TOKEN_BYTES);
+    s.id = nextSerial * AUTH_SESSION_BUCKETS | bucket; // Sıra numarası en az 1: kimlik 0 olmaz
+    nextSerial = nextSerial % (UINT32_MAX / AUTH_SESSION_BUCKETS) + 1;
+    s.refreshedAt = now;
+    s.lastSeen = now;
+    sessionCount++;
+    uint32_t id = s.id;
+    portEXIT_CRITICAL(&sessionMux);
+
+    logTimeouts(expired);
+    return id;
+}
+
+bool checkSession(AsyncWebServerRequest* request) {
+    return lookupSession(request, false) != 0;
+}
+
+uint32_t getSessionId(AsyncWebServerRequest* request) {
+    return lookupSession(request, false);
+}
+
+// Kalıcı bağlantılar (WebSocket, SSE) açıldıkları oturuma bağlıdır
+bool isSessionActive(uint32_t sessionId) {
+    if (sessionId == 0) return false;
+
+    AuthSession& s = sessions[sessionId & (AUTH_SESSION_BUCKETS - 1)];
+    bool active = false;
+    int expired = 0;
+
+    portENTER_CRITICAL(&sessionMux);
+    if (s.id == sessionId) {
+        if (isExpired(s, millis())) {
+            releaseSession(s);
+            authStats.timeouts++;
+            expired = 1;
+        } else {
+            active = true;
+        }
+    }
+    portEXIT_CRITICAL(&sessionMux);
+
+    logTimeouts(expired);
+    return active;
+}
+
+void endAllSessions() {
+    portENTER_CRITICAL(&sessionMux);
+    for (int i = 0; i < AUTH_SESSION_BUCKETS; i++) {
+        if (sessions[i].id != 0) releaseSession(sessions[i]);
+    }
+    portEXIT_CRITICAL(&sessionMux);
+}
+
+int getActiveSessionCount() {
+    portENTER_CRITICAL(&sessionMux);
+    int expired = sweepExpired(millis());
+    int count = sessionCount;
+    portEXIT_CRITICAL(&sessionMux);
+
+    logTimeouts(expired);
+    return count;
+}
+
 // Güvenlik iyileştirmeleri eklenmiş login handler
-void handleUserLogin() {
+void handleUserLogin(AsyncWebServerRequest* request) {
     // Rate limiting kontrolü
     if (lockoutTime > 0 && millis() < lockoutTime) {
         unsigned long remainingTime = (lockoutTime - millis()) / 1000;
         addLog("Çok fazla başarısız giriş denemesi. Kalan süre: " + String(remainingTime) + "s", WARN, "AUTH");
-        server.send(429, "application/json", "{\"error\":\"Çok fazla başarısız deneme. " + String(remainingTime) + " saniye sonra tekrar deneyin.\"}");
+        sendJsonError(request, 429, ("Çok fazla başarısız deneme. " + String(remainingTime) + " saniye sonra tekrar deneyin.").c_str());
         return;
     }
 
-    String u = server.arg("username");
-    String p = server.arg("password");
+    String u = request->arg("username");
+    String p = request->arg("password");
 
     // Input validation
     if (u.length() == 0 || p.length() == 0) {
-        server.send(400, "application/json", "{\"error\":\"Kullanıcı adı ve şifre boş olamaz.\"}");
+        sendJsonError(request, 400, "Kullanıcı adı ve şifre boş olamaz.");
         return;
     }
 
     // Kullanıcı adı ve şifre uzunluk kontrolü
     if (u.length() > 50 || p.length() > 100) {
         addLog("Aşırı uzun giriş denemesi.", WARN, "AUTH");
-        server.send(400, "application/json", "{\"error\":\"Geçersiz giriş bilgileri.\"}");
+        sendJsonError(request, 400, "Geçersiz giriş bilgileri.");
         return;
     }
 
     if (u == settings.username) {
         String hashedAttempt = sha256(p, settings.passwordSalt);
         if (hashedAttempt == settings.passwordHash) {
-            settings.isLoggedIn = true;
-            settings.sessionStartTime = millis();
+            uint8_t token[AUTH_TOKEN_BYTES];
+            bool evicted;
+            createSession(token, evicted);
             loginAttempts = 0; // Başarılı girişte sayacı sıfırla
             lockoutTime = 0;   // Kilitlenmeyi kaldır
+            authStats.loginSuccess++;
+            
+            if (evicted) {
+                addLog("Oturum tablosu dolu, en eski oturum kapatıldı.", WARN, "AUTH");
+            }
+            addLog("✅ Başarılı giriş: " + u + " (" + String(getActiveSessionCount()) + "/" + String(AUTH_MAX_SESSIONS) + " oturum)", SUCCESS, "AUTH");
             
-            addLog("✅ Başarılı giriş: " + u, SUCCESS, "AUTH");
-            server.sendHeader("Location", "/", true);
-            server.send(302, "text/plain", "Yönlendiriliyor...");
+            // Anahtar yalnızca HttpOnly çerezde: betikler okuyamaz
+            char cookie[96];
+            int len = snprintf(cookie, sizeof(cookie), AUTH_COOKIE_NAME "=");
+            for (int i = 0; i < AUTH_TOKEN_BYTES; i++) {
+                len += snprintf(cookie + len, sizeof(cookie) - len, "%02x", token[i]);
+            }
+            snprintf(cookie + len, sizeof(cookie) - len, "; Path=/; HttpOnly; SameSite=Strict");
+            sendRedirect(request, "/", cookie);
             return;
         }
     }
 
     // Başarısız giriş işlemi
     loginAttempts++;
+    authStats.loginFailure++;
     addLog("❌ Başarısız giriş denemesi (#" + String(loginAttempts) + "): " + u, ERROR, "AUTH");
 
     // Maksimum deneme sayısına ulaşıldı mı?
     if (loginAttempts >= MAX_LOGIN_ATTEMPTS) {
         lockoutTime = millis() + LOCKOUT_DURATION;
+        authStats.lockouts++;
         addLog("🔒 IP adresi " + String(LOCKOUT_DURATION/1000) + " saniye kilitlendi.", WARN, "AUTH");
-        server.send(429, "application/json", "{\"error\":\"Çok fazla başarısız deneme. " + String(LOCKOUT_DURATION/1000) + " saniye sonra tekrar deneyin.\"}");
+        sendJsonError(request, 429, ("Çok fazla başarısız deneme. " + String(LOCKOUT_DURATION/1000) + " saniye sonra tekrar deneyin.").c_str());
         return;
     }
 
-    String errorMessage = "Kullanıcı adı veya şifre hatalı!";
-    server.send(401, "application/json", "{\"error\":\"" + errorMessage + "\"}");
+    sendJsonError(request, 401, "Kullanıcı adı veya şifre hatalı!");
 }
 
-void handleUserLogout() {
-    if (settings.isLoggedIn) {
-        settings.isLoggedIn = false;
-        addLog("🚪 Çıkış yapıldı.", INFO, "AUTH");
+// Yalnızca bu isteğin oturumu kapanır, diğer kullanıcılar etkilenmez
+void handleUserLogout(AsyncWebServerRequest* request) {
+    uint32_t id = getSessionId(request);
+    if (id != 0) {
+        bool ended = false;
+        portENTER_CRITICAL(&sessionMux);
+        AuthSession& s = sessions[id & (AUTH_SESSION_BUCKETS - 1)];
+        if (s.id == id) {
+            releaseSession(s);
+            ended = true;
+        }
+        portEXIT_CRITICAL(&sessionMux);
+
+        if (ended) {
+            authStats.logouts++;
+            addLog("🚪 Çıkış yapıldı.", INFO, "AUTH");
+        }
     }
-    server.sendHeader("Location", "/login", true);
-    server.send(302, "text/plain", "Yönlendiriliyor...");
+    sendRedirect(request, "/login", AUTH_COOKIE_NAME "=; Path=/; Max-Age=0; HttpOnly; SameSite=Strict");
 }
 
-// Session yenileme fonksiyonu (AJAX çağrıları için)
-void refreshSession() {
-    if (settings.isLoggedIn) {
-        settings.sessionStartTime = millis();
-    }
-}
\ No newline at end of file
+// Session yenileme fonksiyonu (AJAX çağrıları için); oturum yoksa false
+bool refreshSession(AsyncWebServerRequest* request) {
+    return lookupSession(request, true) != 0;
+}
+
+const AuthStats& getAuthStats() {
+    return authStats;
+}
@@ -0,0 +1,168 @@
+#include "crash_log.h"
+#include <esp_system.h>
+
+#define CRASH_LOG_MAGIC 0x434C4F47 // "CLOG"
+
+// Yazılımsal reset ve panic sonrasında korunan alan.
+// RTC_NOINIT_ATTR sayesinde açılışta sıfırlanmaz, flash'a hiç yazılmaz.
+struct CrashLogArea {
+    uint32_t magic;
+    uint32_t bootCount;
+    uint16_t head;
+    uint16_t count;
+    char restartNote[CRASH_LOG_REASON_LEN];
+    CrashLogRecord records[CRASH_LOG_CAPACITY];
+};
+
+RTC_NOINIT_ATTR static CrashLogArea crashArea;
+
+// Önceki açılışın kayıtları (en eskiden en yeniye)
+static CrashLogRecord previousRecords[CRASH_LOG_CAPACITY];
+static int previousCount = 0;
+static char previousNote[CRASH_LOG_REASON_LEN] = "";
+static esp_reset_reason_t resetReason = ESP_RST_UNKNOWN;
+static bool importing = false;
+
+// Sonda yarım kalan UTF-8 dizisi atılır: Türkçe karakter ve emojiler bayt sınırında
+// kesilince /api/crashlog JSON'una bozuk karakter gitmesin
+static void trimPartialUtf8(char* s) {
+    size_t len = strlen(s);
+    size_t cont = 0;
+    while (cont < len && cont < 3 && ((uint8_t)s[len - 1 - cont] & 0xC0) == 0x80) cont++;
+    if (cont == len) {
+        s[0] = '\0';
+        return;
+    }
+
+    size_t leadPos = len - 1 - cont;
+    uint8_t lead = (uint8_t)s[leadPos];
+    size_t need = (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : (lead & 0xF8) == 0xF0 ? 4 : 1;
+    if (need == 1) {
+        if (cont > 0) s[leadPos + 1] = '\0';   // Başsız devam baytları
+    } else if (cont + 1 < need) {
+        s[leadPos] = '\0';
+    }
+}
+
+static void copyField(char* dest, size_t size, const char* src) {
+    strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+    if (strlen(src) >= size) trimPartialUtf8(dest);
+}
+
+static bool isCrashAreaValid() {
+    return crashArea.magic == CRASH_LOG_MAGIC &&
+           crashArea.head < CRASH_LOG_CAPACITY &&
+           crashArea.count <= CRASH_LOG_CAPACITY;
+}
+
+// RTC alanını doğrula, önceki açılışın kayıtlarını RAM'e al ve alanı yeni açılış için hazırla.
+// Log sisteminden bağımsızdır; setup()'ın en başında çağrılır.
+void initCrashLog() {
+    resetReason = esp_reset_reason();
+    previousCount = 0;
+    previousNote[0] = '\0';
+
+    // Güç kesintisinden sonra RTC içeriği rastgeledir
+    bool coldBoot = (resetReason == ESP_RST_POWERON || resetReason == ESP_RST_BROWNOUT);
+
+    if (!coldBoot && isCrashAreaValid()) {
+        int start = (crashArea.head - crashArea.count + CRASH_LOG_CAPACITY) % CRASH_LOG_CAPACITY;
+        for (int i = 0; i < crashArea.count; i++) {
+            CrashLogRecord& rec = previousRecords[previousCount];
+            rec = crashArea.records[(start + i) % CRASH_LOG_CAPACITY];
+            // Yazma sırasında panic olduysa kayıt yarım kalmış olabilir
+            rec.source[CRASH_LOG_SOURCE_LEN - 1] = '\0';
+            rec.message[CRASH_LOG_MESSAGE_LEN - 1] = '\0';
+            trimPartialUtf8(rec.source);
+            trimPartialUtf8(rec.message);
+            if (rec.level > SUCCESS) rec.level = ERROR;
+            previousCount++;
+        }
+        copyField(previousNote, sizeof(previousNote), crashArea.restartNote);
+        crashArea.bootCount++;
+    } else {
+        crashArea.bootCount = 0;
+    }
+
+    crashArea.magic = CRASH_LOG_MAGIC;
+    crashArea.head = 0;
+    crashArea.count = 0;
+    crashArea.restartNote[0] = '\0';
+}
+
+// Önceki açılışın kayıtlarını normal log'a aktar (initLogSystem içinden)
+void importCrashLog() {
+    if (resetReason == ESP_RST_POWERON) return;
+
+    importing = true;
+    String header = "🧾 Önceki açılıştan " + String(previousCount) +
+                    " kayıt kurtarıldı. Reset nedeni: " + String(getResetReasonString());
+    if (previousNote[0] != '\0') {
+        header += " (" + String(previousNote) + ")";
+    }
+    addLog(header, resetReason == ESP_RST_SW ? INFO : WARN, "CRASH");
+
+    for (int i = 0; i < previousCount; i++) {
+        const CrashLogRecord& rec = previousRecords[i];
+        addLog("⏮️ [+" + String(rec.millis_time / 1000) + "s] " + String(rec.message),
+               (LogLevel)rec.level, String(rec.source));
+    }
+    importing = false;
+}
+
+// addLog tarafından her kayıtta çağrılır; yalnızca sabit boyutlu kopyalama yapar
+void crashLogRecord(const String& msg, LogLevel level, const String& source) {
+    if (importing) return;
+
+    CrashLogRecord& rec = crashArea.records[crashArea.head];
+    rec.millis_time = millis();
+    rec.level = (uint8_t)level;
+    copyField(rec.source, sizeof(rec.source), source.c_str());
+    copyField(rec.message, sizeof(rec.message), msg.c_str());
+
+    // Kayıt tamamlandıktan sonra başı ilerlet
+    crashArea.head = (crashArea.head + 1) % CRASH_LOG_CAPACITY;
+    if (crashArea.count < CRASH_LOG_CAPACITY) {
+        crashArea.count++;
+    }
+}
+
+// ESP.restart() öncesinde neden bilgisini sakla
+void crashLogNoteRestart(const char* reason) {
+    if (crashArea.magic != CRASH_LOG_MAGIC) return;
+    copyField(crashArea.restartNote, sizeof(crashArea.restartNote), reason);
+}
+
+int getCrashLogCount() {
+    return previousCount;
+}
+
+const CrashLogRecord* getCrashLogRecord(int index) {
+    if (index < 0 || index >= previousCount) return nullptr;
+    return &previousRecords[index];
+}
+
+const char* getResetReasonString() {
+    switch (resetReason) {
+        case ESP_RST_POWERON:   return "POWERON";
+        case ESP_RST_EXT:       return "EXTERNAL";
+        case ESP_RST_SW:        return "SOFTWARE";
+        case ESP_RST_PANIC:     return "PANIC";
+        case ESP_RST_INT_WDT:   return "INT_WDT";
+        case ESP_RST_TASK_WDT:  return "TASK_WDT";
+        case ESP_RST_WDT:       return "WDT";
+        case ESP_RST_DEEPSLEEP: return "DEEPSLEEP";
+        case ESP_RST_BROWNOUT:  return "BROWNOUT";
+        case ESP_RST_SDIO:      return "SDIO";
+        default:                return "UNKNOWN";
+    }
+}
+
+const char* getPreviousRestartNote() {
+    return previousNote;
+}
+
+uint32_t getBootCount() {
+    return crashArea.bootCount;
+}
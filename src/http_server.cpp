@@ -0,0 +1,793 @@
+#include "http_server.h"
+#include "settings.h"
+#include "log_system.h"
+#include "route_metrics.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <new>
+
+// Olay tabanlı sunucu: istekler AsyncTCP görevinde işlenir. Eşzamanlı istek sayısı
+// havuzdaki yuva sayısıyla sınırlıdır; her yuvanın yanıt tamponu bağlantı kapanana
+// kadar isteğe aittir, bu yüzden yanıtlar kopyalanmadan doğrudan tampondan gönderilir.
+// HTTP keep-alive yok: kütüphane her TCP bağlantısına tek istek nesnesi kurar ve yanıt
+// bitince "Connection: close" ile kapatır. Sürekli akan veri (durum, log) bu yüzden
+// kalıcı WebSocket/SSE bağlantılarından gider; tek seferlik istekler yeni bağlantı açar.
+static HttpSlot slots[HTTP_MAX_CONNECTIONS];
+static int poolSize = 0;
+static int activeCount = 0;
+static int peakCount = 0;
+static uint32_t rejectedCount = 0;
+static portMUX_TYPE slotMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Bloklayan işler (UART) loop()'ta çalıştırılır; yanıtı AsyncTCP görevindeki
+// DeferredResponse gönderir. Kayıt, iş bitip yanıt nesnesi de yok edilince boşalır.
+struct DeferredRequest {
+    HttpSlot* slot;                     // Sonuç yuva tamponunda, kayıt boşalana kadar tutulur
+    DeferredWork work;
+    int code;
+    size_t length;
+    bool msgpack;
+    bool used;
+    bool done;                          // loop(): sonuç hazır
+    bool abandoned;                     // Yanıt nesnesi yok edildi (gönderildi ya da istemci ayrıldı)
+};
+
+static DeferredRequest deferred[HTTP_MAX_DEFERRED];
+static SemaphoreHandle_t deferredMutex = nullptr;
+
+// Yuvası olmayan istekler için: kapasitesi sıfır, her ayırma heap'e gider (açıkça istenmiş tek yer)
+static JsonArena heapOnlyArena;
+
+// Yuva tamponuna sığmayan belgeler için tek ortak tampon; aynı anda bir yanıt kullanır
+static char* largeBuffer = nullptr;
+static size_t largeBufferSize = 0;
+static bool largeBufferBusy = false;
+
+bool initHttpServer() {
+    bool psram = psramFound();
+    int count = psram ? HTTP_MAX_CONNECTIONS : HTTP_FALLBACK_CONNECTIONS;
+
+    // Yanıt tamponu ve belge bölgesi tek blokta
+    for (int i = 0; i < count; i++) {
+        size_t total = HTTP_BUFFER_SIZE + HTTP_ARENA_SIZE;
+        char* buffer = (char*)(psram ? ps_malloc(total) : malloc(total));
+        if (!buffer) break;
+        slots[i].request = nullptr;
+        slots[i].buffer = buffer;
+        slots[i].size = HTTP_BUFFER_SIZE;
+        slots[i].arena.begin((uint8_t*)buffer + HTTP_BUFFER_SIZE, HTTP_ARENA_SIZE);
+        slots[i].holds = 0;
+        slots[i].stream = nullptr;
+        poolSize++;
+    }
+    heapOnlyArena.begin(nullptr, 0, true);
+
+    largeBufferSize = psram ? HTTP_LARGE_BUFFER_SIZE : HTTP_LARGE_BUFFER_SIZE / 2;
+    largeBuffer = (char*)(psram ? ps_malloc(largeBufferSize) : malloc(largeBufferSize));
+    if (!largeBuffer) largeBufferSize = 0;
+
+    deferredMutex = xSemaphoreCreateMutex();
+
+    // Tüm yanıtlara eklenen güvenlik başlıkları
+    DefaultHeaders::Instance().addHeader("X-Content-Type-Options", "nosniff");
+    DefaultHeaders::Instance().addHeader("X-Frame-Options", "DENY");
+    DefaultHeaders::Instance().addHeader("X-XSS-Protection", "1; mode=block");
+    DefaultHeaders::Instance().addHeader("Strict-Transport-Security", "max-age=31536000; includeSubDomains");
+
+    if (poolSize == 0) {
+        addLog("❌ HTTP bağlantı havuzu ayrılamadı!", ERROR, "WEB");
+        return false;
+    }
+    addLog("HTTP havuzu: " + String(poolSize) + " bağlantı x " + String((HTTP_BUFFER_SIZE + HTTP_ARENA_SIZE) / 1024) + " KB (" +
+           (psram ? "PSRAM" : "dahili RAM") + ")", INFO, "WEB");
+    return true;
+}
+
+static HttpSlot* acquireSlot(AsyncWebServerRequest* request) {
+    HttpSlot* slot = nullptr;
+    portENTER_CRITICAL(&slotMux);
+    for (int i = 0; i < poolSize; i++) {
+        if (slots[i].request == nullptr && slots[i].holds == 0) {
+            slots[i].request = request;
+            slots[i].arena.reset();
+            slots[i].bytes = 0;
+            slots[i].handlerUs = 0;
+            slots[i].stream = nullptr;
+            slot = &slots[i];
+            activeCount++;
+            if (activeCount > peakCount) peakCount = activeCount;
+            break;
+        }
+    }
+    if (!slot) rejectedCount++;
+    portEXIT_CRITICAL(&slotMux);
+    return slot;
+}
+
+static void destroyStream(HttpSlot* slot);
+
+static void releaseRequest(AsyncWebServerRequest* request) {
+    // Akış durumu yuva başka isteğe verilmeden yok edilir
+    HttpSlot* slot = getHttpSlot(request);
+    if (slot) destroyStream(slot);
+
+    portENTER_CRITICAL(&slotMux);
+    for (int i = 0; i < poolSize; i++) {
+        if (slots[i].request == request) {
+            slots[i].request = nullptr;
+            activeCount--;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&slotMux);
+}
+
+HttpSlot* getHttpSlot(AsyncWebServerRequest* request) {
+    for (int i = 0; i < poolSize; i++) {
+        if (slots[i].request == request) return &slots[i];
+    }
+    return nullptr;
+}
+
+ArduinoJson::Allocator* getJsonAllocator(AsyncWebServerRequest* request) {
+    HttpSlot* slot = getHttpSlot(request);
+    return slot ? (ArduinoJson::Allocator*)&slot->arena : &heapOnlyArena;
+}
+
+// Bağlantı kapanana kadar geçerli bellek (isteğin belge bölgesinden); yuva yoksa ya da bölge doluysa nullptr
+void* allocateRequestMemory(AsyncWebServerRequest* request, size_t size) {
+    HttpSlot* slot = getHttpSlot(request);
+    return slot ? slot->arena.allocate(size) : nullptr;
+}
+
+// Bölge, istek kapandıktan sonra da kullanılıyorsa yuva yeniden verilmez
+static void holdSlot(HttpSlot* slot) {
+    if (!slot) return;
+    portENTER_CRITICAL(&slotMux);
+    slot->holds++;
+    portEXIT_CRITICAL(&slotMux);
+}
+
+static void unholdSlot(HttpSlot* slot) {
+    if (!slot) return;
+    portENTER_CRITICAL(&slotMux);
+    slot->holds--;
+    portEXIT_CRITICAL(&slotMux);
+}
+
+static const char* contentTypeFor(bool msgpack) {
+    return msgpack ? "application/msgpack" : "application/json";
+}
+
+static void sendBusy(AsyncWebServerRequest* request) {
+    AsyncWebServerResponse* response = request->beginResponse(503, "application/json", "{\"error\":\"Sunucu meşgul\"}");
+    response->addHeader("Retry-After", "1");
+    request->send(response);
+}
+
+static bool acquireLargeBuffer() {
+    bool acquired = false;
+    portENTER_CRITICAL(&slotMux);
+    if (largeBuffer && !largeBufferBusy) {
+        largeBufferBusy = true;
+        acquired = true;
+    }
+    portEXIT_CRITICAL(&slotMux);
+    return acquired;
+}
+
+static void releaseLargeBuffer() {
+    portENTER_CRITICAL(&slotMux);
+    largeBufferBusy = false;
+    portEXIT_CRITICAL(&slotMux);
+}
+
+// Önceden serileştirilmiş gövdeyi bir tampondan parça parça gönderen yanıt
+class BufferResponse : public AsyncAbstractResponse {
+public:
+    BufferResponse(const char* data, size_t length, bool msgpack) : data(data), length(length) {
+        setContentType(contentTypeFor(msgpack));
+        setContentLength(length);
+    }
+
+    bool _sourceValid() const override { return true; }
+
+    size_t _fillBuffer(uint8_t* buffer, size_t maxLen) override {
+        size_t n = length - sent < maxLen ? length - sent : maxLen;
+        memcpy(buffer, data + sent, n);
+        sent += n;
+        return n;
+    }
+
+protected:
+    const char* data;
+    size_t length;
+    size_t sent = 0;
+};
+
+// Büyük tampondaki yanıt: yanıt nesnesi yok edilince (gönderildi ya da istemci ayrıldı) tampon bırakılır
+class LargeBufferResponse : public BufferResponse {
+public:
+    LargeBufferResponse(size_t length, bool msgpack) : BufferResponse(largeBuffer, length, msgpack) {}
+    ~LargeBufferResponse() override { releaseLargeBuffer(); }
+};
+
+static const char* methodName(WebRequestMethodComposite method) {
+    if (method == HTTP_GET) return "GET";
+    if (method == HTTP_POST) return "POST";
+    return "ANY";
+}
+
+// Yanıt gövdesi gönderen yardımcılar bildirir; yuvası olmayan istekte sayılmaz
+void countResponseBytes(AsyncWebServerRequest* request, size_t bytes) {
+    HttpSlot* slot = getHttpSlot(request);
+    if (slot) slot->bytes += bytes;
+}
+
+// Bağlantı kapanınca yuva serbest kalır ve istek rota ölçümüne yazılır
+static void finishRequest(AsyncWebServerRequest* request, int route, uint32_t startedUs) {
+    uint32_t durationUs = micros() - startedUs;
+    HttpSlot* slot = getHttpSlot(request);
+    uint32_t bytes = slot ? slot->bytes : 0;
+    uint32_t handlerUs = slot ? slot->handlerUs : 0;
+    const AsyncWebServerResponse* response = request->getResponse();
+    recordRouteRequest(route, request->url(), response ? response->code() : 0, bytes, durationUs, handlerUs);
+    releaseRequest(request);
+}
+
+// Önce istemcinin token kovası, sonra havuz: aşan istemci 429, havuz doluysa 503.
+static ArRequestHandlerFunction wrapRoute(int route, HttpHandler handler, uint16_t cost) {
+    return [route, handler, cost](AsyncWebServerRequest* request) {
+        uint32_t startedUs = micros();
+        request->onDisconnect([request, route, startedUs]() { finishRequest(request, route, startedUs); });
+
+        uint32_t retryAfter = 0;
+        if (!rateLimitTake((uint32_t)request->client()->remoteIP(), cost, &retryAfter)) {
+            AsyncWebServerResponse* response = request->beginResponse(429, "application/json", "{\"error\":\"Çok fazla istek\"}");
+            response->addHeader("Retry-After", String(retryAfter));
+            request->send(response);
+            return;
+        }
+        HttpSlot* slot = acquireSlot(request);
+        if (!slot) {
+            sendBusy(request);
+            return;
+        }
+        slot->startedUs = startedUs;
+        handler(request);
+        if (slot->handlerUs == 0) slot->handlerUs = micros() - startedUs;
+    };
+}
+
+void addRoute(const char* uri, WebRequestMethodComposite method, HttpHandler handler, uint16_t cost) {
+    int route = registerRouteMetrics(uri, methodName(method));
+    server.on(uri, method, wrapRoute(route, handler, cost));
+}
+
+// Eşleşmeyen istekler de diğer rotalar gibi sınırlanır ve ölçülür
+void addNotFoundRoute(HttpHandler handler, uint16_t cost) {
+    int route = registerRouteMetrics("*", "ANY");
+    server.onNotFound(wrapRoute(route, handler, cost));
+}
+
+void addSecurityHeaders(AsyncWebServerResponse* response) {
+    response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    response->addHeader("Pragma", "no-cache");
+    response->addHeader("Expires", "0");
+}
+
+// İstemci "Accept: application/msgpack" gönderdiyse yanıtlar MessagePack olur, varsayılan JSON
+bool wantsMsgPack(AsyncWebServerRequest* request) {
+    return request->hasHeader("Accept") && request->header("Accept").indexOf("application/msgpack") >= 0;
+}
+
+// Aynı kaynağın iki gösterimi ayrı ETag taşır: "...-m"
+static const char* representationETag(bool msgpack, const char* etag, char* out, size_t size) {
+    size_t len = strlen(etag);
+    if (!msgpack || len < 2 || len + 3 > size) return etag;
+    memcpy(out, etag, len - 1);
+    memcpy(out + len - 1, "-m\"", 4);
+    return out;
+}
+
+// ETag'li yanıt: tarayıcı saklayabilir ama her kullanımda doğrulatmalı
+static void addValidatorHeaders(AsyncWebServerResponse* response, const char* etag) {
+    response->addHeader("Cache-Control", "private, no-cache");
+    response->addHeader("Vary", "Accept");
+    response->addHeader("ETag", etag);
+}
+
+// İstemcinin kopyası güncelse gövde üretmeden 304 gönderir
+bool sendNotModified(AsyncWebServerRequest* request, const char* etag) {
+    if (!request->hasHeader("If-None-Match")) return false;
+    bool msgpack = wantsMsgPack(request);
+    char variant[48];
+    etag = representationETag(msgpack, etag, variant, sizeof(variant));
+    if (request->header("If-None-Match").indexOf(etag) < 0) return false;
+
+    AsyncWebServerResponse* response = request->beginResponse(304, contentTypeFor(msgpack), "");
+    addValidatorHeaders(response, etag);
+    request->send(response);
+    return true;
+}
+
+// Belge bir kez serileştirilir: yuva tamponuna sığıyorsa oraya, sığmıyorsa ortak büyük
+// tampona. Büyük tampon kullanımdaysa 503, ona da sığmıyorsa 500 döner; dizi taşıyan
+// büyük yanıtlar sendJsonStream ile gönderilmeli.
+void sendJson(AsyncWebServerRequest* request, int code, JsonDocument& doc, const char* etag) {
+    AsyncWebServerResponse* response;
+    HttpSlot* slot = getHttpSlot(request);
+    bool msgpack = wantsMsgPack(request);
+    if (doc.overflowed()) {
+        // Belge bölgesi dolu: yarım belge gönderilmez (hata da sabit metinle)
+        addLog("Yanıt belgesi bölgeye sığmadı: " + request->url(), ERROR, "WEB");
+        request->send(500, "application/json", "{\"error\":\"Yanıt çok büyük\"}");
+        return;
+    }
+    size_t length = msgpack ? measureMsgPack(doc) : measureJson(doc);
+
+    if (slot && length < slot->size) {
+        // Yuva tamponundan kopyasız gönderim
+        if (msgpack) {
+            serializeMsgPack(doc, slot->buffer, slot->size);
+        } else {
+            serializeJson(doc, slot->buffer, slot->size);
+        }
+        response = request->beginResponse(code, contentTypeFor(msgpack), (const uint8_t*)slot->buffer, length);
+        slot->bytes += length;
+    } else if (length >= largeBufferSize) {
+        addLog("Yanıt tampona sığmıyor: " + request->url() + " (" + String(length) + " bayt)", ERROR, "WEB");
+        request->send(500, "application/json", "{\"error\":\"Yanıt çok büyük\"}");
+        return;
+    } else if (!acquireLargeBuffer()) {
+        sendBusy(request);
+        return;
+    } else {
+        if (msgpack) {
+            serializeMsgPack(doc, largeBuffer, largeBufferSize);
+        } else {
+            serializeJson(doc, largeBuffer, largeBufferSize);
+        }
+        response = new LargeBufferResponse(length, msgpack);
+        response->setCode(code);
+        countResponseBytes(request, length);
+    }
+    if (etag) {
+        char variant[48];
+        addValidatorHeaders(response, representationETag(msgpack, etag, variant, sizeof(variant)));
+    } else {
+        addSecurityHeaders(response);
+    }
+    request->send(response);
+}
+
+// Akış yanıtının durumu: yuva tamponunda kurulur ve bağlantı kapanınca yok edilir, boyutu
+// öğe sayısından bağımsızdır. Her öğe kendi küçük bölgesinde kurulur ve serileştirildikten
+// sonra bölge sıfırlanır; sığmayan öğe heap'e taşmaz, atlanır.
+struct JsonStream {
+    HttpSlot* slot = nullptr;   // Gönderilen bayt sayısı için
+    char head[HTTP_STREAM_HEAD_SIZE];   // JSON: '{...,"key":[', MessagePack: harita + dizi başlığı
+    size_t headLen = 0;
+    bool msgpack = false;
+    size_t count = 0;           // MessagePack: başlıkta bildirilen öğe sayısı
+    JsonItemSource source;
+    uint8_t itemMemory[HTTP_STREAM_ARENA_SIZE];
+    JsonArena itemArena;
+    JsonDocument item{&itemArena};
+    char piece[HTTP_STREAM_ITEM_SIZE];
+    const char* current = nullptr;
+    size_t currentLen = 0;
+    size_t currentPos = 0;
+    size_t index = 0;
+    size_t emitted = 0;
+    uint8_t phase = 0;          // 0: baş, 1: öğeler, 2: kapanış, 3: bitti
+};
+
+static_assert(sizeof(JsonStream) <= HTTP_BUFFER_SIZE, "JsonStream yuva tamponuna sığmalı");
+
+static void destroyStream(HttpSlot* slot) {
+    if (!slot->stream) return;
+    slot->stream->~JsonStream();
+    slot->stream = nullptr;
+}
+
+// Öğe kaynağından okunan öğe gönderilebilir mi (boş ya da bölgeye sığmamış değil)
+static bool usableItem(JsonDocument& item) {
+    return !item.isNull() && !item.overflowed();
+}
+
+// MessagePack dizisinin boyu başta yazılır: kaybolan, sığmayan ya da eksik kalan
+// öğelerin yerine nil gönderilir, bildirilen sayıdan fazlası gönderilmez.
+static bool nextPackedItem(JsonStream& s) {
+    if (s.emitted >= s.count) return false;
+    s.item.clear();
+    s.itemArena.reset();
+    bool present = s.source(s.index++, s.item) && usableItem(s.item) &&
+                   measureMsgPack(s.item) < sizeof(s.piece);
+    if (present) {
+        s.currentLen = serializeMsgPack(s.item, s.piece, sizeof(s.piece));
+    } else {
+        s.piece[0] = (char)0xc0;
+        s.currentLen = 1;
+    }
+    s.current = s.piece;
+    s.emitted++;
+    return true;
+}
+
+// Sıradaki öğeyi piece'e serileştirir; öğe kalmadıysa false
+static bool nextItem(JsonStream& s) {
+    if (s.msgpack) return nextPackedItem(s);
+    while (true) {
+        s.item.clear();
+        s.itemArena.reset();
+        if (!s.source(s.index++, s.item)) return false;
+        if (!usableItem(s.item)) continue;
+
+        size_t offset = s.emitted > 0 ? 1 : 0;
+        if (measureJson(s.item) + offset >= sizeof(s.piece)) continue; // Sığmayan öğe atlanır
+        if (offset) s.piece[0] = ',';
+        s.currentLen = offset + serializeJson(s.item, s.piece + offset, sizeof(s.piece) - offset);
+        s.current = s.piece;
+        s.emitted++;
+        return true;
+    }
+}
+
+static bool nextPiece(JsonStream& s) {
+    s.currentPos = 0;
+    switch (s.phase) {
+        case 0:
+            s.current = s.head;
+            s.currentLen = s.headLen;
+            s.phase = 1;
+            return true;
+        case 1:
+            if (nextItem(s)) return true;
+            s.phase = 2;
+            // fall through
+        case 2:
+            s.current = "]}";
+            s.currentLen = s.msgpack ? 0 : 2;
+            s.phase = 3;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static size_t fillStream(JsonStream& s, uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (s.currentPos >= s.currentLen) {
+            if (!nextPiece(s)) break;
+            continue;
+        }
+        size_t n = s.currentLen - s.currentPos;
+        if (n > maxLen - written) n = maxLen - written;
+        memcpy(buffer + written, s.current + s.currentPos, n);
+        s.currentPos += n;
+        written += n;
+    }
+    if (s.slot) s.slot->bytes += written;
+    return written;
+}
+
+// JSON başı: head nesnesi kapanmadan dizinin anahtarı eklenir; sığmazsa false
+static bool buildJsonHead(JsonStream& s, JsonDocument& head, const char* arrayKey) {
+    size_t length = measureJson(head);
+    size_t keyLength = strlen(arrayKey);
+    if (length + keyLength + 5 > sizeof(s.head)) return false;
+    serializeJson(head, s.head, length + 1);
+
+    size_t pos = length <= 2 ? 1 : length;
+    if (length > 2) s.head[length - 1] = ',';
+    s.head[pos++] = '"';
+    memcpy(s.head + pos, arrayKey, keyLength);
+    pos += keyLength;
+    memcpy(s.head + pos, "\":[", 3);
+    s.headLen = pos + 3;
+    return true;
+}
+
+// MessagePack başı: boş dizi son alan olarak eklenir, serileştirmedeki boş dizi
+// işareti (0x90) öğe sayısını taşıyan başlıkla değiştirilir
+static bool buildPackedHead(JsonStream& s, JsonDocument& head, const char* arrayKey) {
+    head.remove(arrayKey);
+    head[arrayKey].to<JsonArray>();
+    size_t length = measureMsgPack(head);
+    if (head.overflowed() || length + 4 > sizeof(s.head)) return false;
+    serializeMsgPack(head, s.head, length);
+
+    size_t pos = length - 1;
+    if (s.count < 16) {
+        s.head[pos++] = (char)(0x90 | s.count);
+    } else if (s.count < 65536) {
+        s.head[pos++] = (char)0xdc;
+        s.head[pos++] = (char)(s.count >> 8);
+        s.head[pos++] = (char)s.count;
+    } else {
+        s.head[pos++] = (char)0xdd;
+        s.head[pos++] = (char)(s.count >> 24);
+        s.head[pos++] = (char)(s.count >> 16);
+        s.head[pos++] = (char)(s.count >> 8);
+        s.head[pos++] = (char)s.count;
+    }
+    s.headLen = pos;
+    return true;
+}
+
+// head nesnesi ve arkasından öğeleri tek tek üretilen bir dizi gönderir: {...,"arrayKey":[...]}
+// HTTP/1.1 istemcilere chunked, HTTP/1.0 istemcilere önceden ölçülen Content-Length ile.
+// MessagePack istenirse öğeler önce sayılır (dizi boyu başta yazılır), gövde uzunluğu
+// bilinmediğinden her iki sürümde de chunked/bağlantı sonu ile gönderilir.
+void sendJsonStream(AsyncWebServerRequest* request, JsonDocument& head, const char* arrayKey, JsonItemSource source) {
+    // Durum yuva tamponunda kurulur: akış yanıtı tamponu başka iş için kullanmaz
+    HttpSlot* slot = getHttpSlot(request);
+    if (!slot || head.overflowed()) {
+        request->send(500, "application/json", "{\"error\":\"Akış yanıtı kurulamadı\"}");
+        return;
+    }
+    JsonStream* stream = new (slot->buffer) JsonStream();
+    slot->stream = stream;
+    stream->itemArena.begin(stream->itemMemory, sizeof(stream->itemMemory));
+    stream->source = source;
+    stream->msgpack = wantsMsgPack(request);
+    stream->slot = slot;
+
+    AsyncWebServerResponse* response;
+    if (stream->msgpack) {
+        while (true) {
+            stream->item.clear();
+            stream->itemArena.reset();
+            if (!source(stream->count, stream->item)) break;
+            stream->count++;
+        }
+        if (!buildPackedHead(*stream, head, arrayKey)) {
+            request->send(500, "application/json", "{\"error\":\"Yanıt başlığı çok büyük\"}");
+            return;
+        }
+        response = request->beginChunkedResponse("application/msgpack",
+            [stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                return fillStream(*stream, buffer, maxLen);
+            });
+        addSecurityHeaders(response);
+        request->send(response);
+        return;
+    }
+
+    if (!buildJsonHead(*stream, head, arrayKey)) {
+        request->send(500, "application/json", "{\"error\":\"Yanıt başlığı çok büyük\"}");
+        return;
+    }
+    if (request->version() >= 1) {
+        response = request->beginChunkedResponse("application/json",
+            [stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                return fillStream(*stream, buffer, maxLen);
+            });
+    } else {
+        // Uzunluk için öğeler bir kez ölçülür
+        size_t length = stream->headLen + 2;
+        size_t items = 0;
+        for (size_t i = 0;; i++) {
+            stream->item.clear();
+            stream->itemArena.reset();
+            if (!source(i, stream->item)) break;
+            if (!usableItem(stream->item)) continue;
+            size_t itemLength = measureJson(stream->item) + (items > 0 ? 1 : 0);
+            if (itemLength >= sizeof(stream->piece)) continue;
+            length += itemLength;
+            items++;
+        }
+
+        // Ölçümden sonra kaybolan öğelerin yeri boşlukla doldurulur (JSON'da geçerli)
+        response = request->beginResponse("application/json", length,
+            [stream, length](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                if (index >= length) return 0;
+                size_t limit = length - index < maxLen ? length - index : maxLen;
+                size_t n = fillStream(*stream, buffer, limit);
+                if (n < limit) {
+                    memset(buffer + n, ' ', limit - n);
+                    if (stream->slot) stream->slot->bytes += limit - n;
+                }
+                return limit;
+            });
+    }
+    addSecurityHeaders(response);
+    request->send(response);
+}
+
+// Sabit JSON metni; MessagePack isteyen istemci için belgeye çözülüp dönüştürülür
+void sendJsonText(AsyncWebServerRequest* request, int code, const char* json) {
+    if (wantsMsgPack(request)) {
+        JsonDocument doc(getJsonAllocator(request));
+        deserializeJson(doc, json);
+        sendJson(request, code, doc);
+        return;
+    }
+    AsyncWebServerResponse* response = request->beginResponse(code, "application/json", json);
+    countResponseBytes(request, strlen(json));
+    addSecurityHeaders(response);
+    request->send(response);
+}
+
+void sendJsonError(AsyncWebServerRequest* request, int code, const char* message) {
+    JsonDocument doc(getJsonAllocator(request));
+    doc["error"] = message;
+    sendJson(request, code, doc);
+}
+
+void sendRedirect(AsyncWebServerRequest* request, const char* location, const char* setCookie) {
+    static const char body[] = "Yönlendiriliyor...";
+    AsyncWebServerResponse* response = request->beginResponse(302, "text/plain", body);
+    countResponseBytes(request, sizeof(body) - 1);
+    response->addHeader("Location", location);
+    if (setCookie) response->addHeader("Set-Cookie", setCookie);
+    request->send(response);
+}
+
+// Kaydı iki taraftan hangisi son bitirirse o boşaltır (deferredMutex tutulurken)
+static void freeDeferredLocked(int index) {
+    unholdSlot(deferred[index].slot);
+    deferred[index].work = nullptr;
+    deferred[index].slot = nullptr;
+    deferred[index].used = false;
+}
+
+// Ertelenmiş isteğin yanıtı: AsyncTCP görevinde yaşar, loop() istek nesnesine hiç dokunmaz.
+// Sonuç hazır olana kadar başlık da gönderilmez; kütüphane bağlantıyı her yoklamasında
+// _ack çağırır ve sonuç o anda hazırsa gönderim başlar. _respond/_ack kütüphanenin iç
+// arayüzüdür: sürümler platformio.ini'de bu yüzden sabitlendi.
+class DeferredResponse : public BufferResponse {
+public:
+    DeferredResponse(int index, HttpSlot* slot, bool msgpack) : BufferResponse(slot->buffer, 0, msgpack), index(index), slot(slot) {}
+
+    ~DeferredResponse() override {
+        xSemaphoreTake(deferredMutex, portMAX_DELAY);
+        deferred[index].abandoned = true;
+        if (deferred[index].done) freeDeferredLocked(index);
+        xSemaphoreGive(deferredMutex);
+    }
+
+    void _respond(AsyncWebServerRequest* request) override {
+        tryStart(request);
+    }
+
+    size_t _ack(AsyncWebServerRequest* request, size_t len, uint32_t time) override {
+        if (!started) {
+            tryStart(request);
+            return 0;
+        }
+        return AsyncAbstractResponse::_ack(request, len, time);
+    }
+
+private:
+    void tryStart(AsyncWebServerRequest* request) {
+        xSemaphoreTake(deferredMutex, portMAX_DELAY);
+        bool ready = deferred[index].done;
+        int code = deferred[index].code;
+        length = deferred[index].length;
+        xSemaphoreGive(deferredMutex);
+        if (!ready) return;
+
+        started = true;
+        setCode(code);
+        setContentLength(length);
+        slot->bytes += length;
+        AsyncAbstractResponse::_respond(request);
+    }
+
+    int index;
+    HttpSlot* slot;
+    bool started = false;
+};
+
+// İş bitene kadar yuva tutulur: istemci ayrılsa da tampon başka isteğe verilmez
+bool deferRequest(AsyncWebServerRequest* request, DeferredWork work) {
+    int index = -1;
+    HttpSlot* slot = getHttpSlot(request);
+    xSemaphoreTake(deferredMutex, portMAX_DELAY);
+    for (int i = 0; slot && i < HTTP_MAX_DEFERRED; i++) {
+        if (!deferred[i].used) {
+            holdSlot(slot);
+            deferred[i].slot = slot;
+            deferred[i].work = work;
+            deferred[i].code = 0;
+            deferred[i].length = 0;
+            deferred[i].msgpack = wantsMsgPack(request);
+            deferred[i].done = false;
+            deferred[i].abandoned = false;
+            deferred[i].used = true;
+            index = i;
+            break;
+        }
+    }
+    xSemaphoreGive(deferredMutex);
+
+    if (index < 0) {
+        sendJsonError(request, 503, "İşlem kuyruğu dolu");
+        return false;
+    }
+    DeferredResponse* response = new DeferredResponse(index, slot, deferred[index].msgpack);
+    addSecurityHeaders(response);
+    request->send(response);
+    return true;
+}
+
+// loop() içinden: her çağrıda bir iş çalıştırılır, sonuç yuva tamponuna serileştirilir
+void runDeferredRequests() {
+    if (!deferredMutex) return;
+
+    int index = -1;
+    xSemaphoreTake(deferredMutex, portMAX_DELAY);
+    for (int i = 0; i < HTTP_MAX_DEFERRED; i++) {
+        if (deferred[i].used && !deferred[i].done) {
+            index = i;
+            break;
+        }
+    }
+    xSemaphoreGive(deferredMutex);
+    if (index < 0) return;
+
+    // İş kilitsiz çalışır; yanıt nesnesi done görene kadar tampona dokunmaz
+    HttpSlot* slot = deferred[index].slot;
+    bool msgpack = deferred[index].msgpack;
+    int code;
+    size_t length;
+    {
+        JsonDocument doc(&slot->arena);
+        code = deferred[index].work(doc);
+        slot->handlerUs = micros() - slot->startedUs;
+        length = msgpack ? measureMsgPack(doc) : measureJson(doc);
+        if (length >= slot->size) {
+            doc.clear();
+            doc["error"] = "Yanıt çok büyük";
+            code = 500;
+            length = msgpack ? measureMsgPack(doc) : measureJson(doc);
+        }
+        if (msgpack) {
+            serializeMsgPack(doc, slot->buffer, slot->size);
+        } else {
+            serializeJson(doc, slot->buffer, slot->size);
+        }
+    }
+
+    xSemaphoreTake(deferredMutex, portMAX_DELAY);
+    deferred[index].code = code;
+    deferred[index].length = length;
+    deferred[index].done = true;
+    if (deferred[index].abandoned) freeDeferredLocked(index);
+    xSemaphoreGive(deferredMutex);
+}
+
+int getHttpActiveConnections() {
+    return activeCount;
+}
+
+int getHttpPeakConnections() {
+    return peakCount;
+}
+
+int getHttpPoolSize() {
+    return poolSize;
+}
+
+uint32_t getHttpRejectedCount() {
+    return rejectedCount;
+}
+
+size_t getHttpArenaPeak() {
+    size_t peak = 0;
+    for (int i = 0; i < poolSize; i++) {
+        if (slots[i].arena.peak() > peak) peak = slots[i].arena.peak();
+    }
+    return peak;
+}
+
+uint32_t getHttpArenaOverflows() {
+    uint32_t total = heapOnlyArena.overflows();
+    for (int i = 0; i < poolSize; i++) {
+        total += slots[i].arena.overflows();
+    }
+    return total;
+}
@@ -0,0 +1,79 @@
+#include "json_arena.h"
+
+// Her bloğun önünde boyutu tutulur (reallocate kopyası için); bloklar 8 bayta hizalı
+struct ArenaBlockHeader {
+    size_t size;
+    size_t reserved;
+};
+
+static inline size_t alignSize(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+void JsonArena::begin(uint8_t* mem, size_t length, bool fallback) {
+    memory = mem;
+    size = length;
+    heapFallback = fallback;
+    reset();
+}
+
+void JsonArena::reset() {
+    offset = 0;
+    lastOffset = SIZE_MAX;
+}
+
+bool JsonArena::owns(const void* ptr) const {
+    return memory && ptr >= memory && ptr < memory + size;
+}
+
+void* JsonArena::allocate(size_t length) {
+    size_t need = sizeof(ArenaBlockHeader) + alignSize(length);
+    if (offset + need > size) {
+        overflowCount++;
+        return heapFallback ? malloc(length) : nullptr;
+    }
+
+    ArenaBlockHeader* header = (ArenaBlockHeader*)(memory + offset);
+    header->size = length;
+    lastOffset = offset;
+    offset += need;
+    if (offset > peakUsed) peakUsed = offset;
+    return header + 1;
+}
+
+void JsonArena::deallocate(void* ptr) {
+    if (!ptr) return;
+    if (!owns(ptr)) {
+        free(ptr);
+        return;
+    }
+    // Yalnızca son blok geri alınır; diğerleri reset()'e kadar bekler
+    if (lastOffset != SIZE_MAX && (uint8_t*)ptr == memory + lastOffset + sizeof(ArenaBlockHeader)) {
+        offset = lastOffset;
+        lastOffset = SIZE_MAX;
+    }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize) {
+    if (!ptr) return allocate(newSize);
+    if (!owns(ptr)) return realloc(ptr, newSize);
+
+    ArenaBlockHeader* header = (ArenaBlockHeader*)ptr - 1;
+
+    // Son blok yerinde büyütülür/küçültülür
+    if (lastOffset != SIZE_MAX && (uint8_t*)header == memory + lastOffset) {
+        size_t end = lastOffset + sizeof(ArenaBlockHeader) + alignSize(newSize);
+        if (end <= size) {
+            header->size = newSize;
+            offset = end;
+            if (offset > peakUsed) peakUsed = offset;
+            return ptr;
+        }
+    }
+
+    void* moved = allocate(newSize);
+    if (!moved) return nullptr;
+    memcpy(moved, ptr, header->size < newSize ? header->size : newSize);
+    deallocate(ptr);
+    return moved;
+}
@@ -0,0 +1,438 @@
+#include "live_socket.h"
+#include "log_stream.h"
+#include "log_store.h"
+#include "log_system.h"
+#include "status_snapshot.h"
+#include "uart_handler.h"
+#include "auth_system.h"
+#include "settings.h"
+#include "http_server.h"
+#include "json_arena.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Tek WebSocket üzerinden konu tabanlı canlı yayın. İstemci "sub:status,log" gibi bir
+// metinle abone olur. Her değişiklik loop()'ta bir kez serileştirilir ve aynı tampon
+// tüm abonelere paylaştırılır. Kuyruğu dolu istemci o mesajı kaçırır; kuyruk boşalınca
+// kaçırdığı konular "resync" ile bildirilir (durum için doğrudan tam görüntü gönderilir).
+static AsyncWebSocket liveSocket("/ws");
+
+// Kütüphane istemciyi WS_EVT_DISCONNECT döndükten sonra siler; olay clientMutex'i
+// beklediği için kilit tutulurken loop()'tan istemciye gönderim güvenlidir.
+// Soket loop()'tan kapatılmaz: oturumu biten istemci işaretlenir, AsyncTCP tarafında kapatılır.
+struct LiveClient {
+    AsyncWebSocketClient* client;   // nullptr: boş
+    uint32_t session;       // Bağlantıyı açan oturum
+    uint8_t topics;
+    uint8_t missed;         // Kuyruk doluyken kaçırılan konular
+    bool fullStatus;        // Sonraki turda tam durum görüntüsü gönderilecek
+    bool ended;             // Oturum sona erdi: bildirildi, AsyncTCP tarafında kapatılacak
+};
+
+static LiveClient clients[LIVE_SOCKET_MAX_CLIENTS];
+static SemaphoreHandle_t clientMutex = nullptr;
+static uint32_t droppedCount = 0;
+
+// Filtreden WS_EVT_CONNECT'e aktarılan oturum, bağlantı (AsyncClient) anahtarıyla: araya
+// başka bir isteğin filtresi girse de her soket kendi isteğinin oturumunu alır.
+// Yalnızca AsyncTCP görevinde kullanılır.
+struct PendingSocket {
+    AsyncClient* conn;
+    uint32_t session;
+    unsigned long at;
+};
+static PendingSocket pendingSockets[LIVE_SOCKET_MAX_CLIENTS];
+
+static uint32_t publishedStatus = 0;
+static uint32_t logCursor = 0;
+static uint32_t logEpoch = 0;
+static uint32_t lastTickSecond = UINT32_MAX;
+static unsigned long lastUartTotal = 0;
+static bool lastUartHealthy = true;
+
+// Mesajlar yalnızca loop()'ta üretilir
+static char message[LIVE_MESSAGE_SIZE];
+static uint8_t arenaMemory[HTTP_STREAM_ARENA_SIZE];
+static JsonArena arena;
+
+static const struct {
+    const char* name;
+    uint8_t bit;
+} topicNames[] = {
+    {"time", LIVE_TOPIC_TIME},
+    {"status", LIVE_TOPIC_STATUS},
+    {"log", LIVE_TOPIC_LOG},
+    {"fault", LIVE_TOPIC_FAULT},
+    {"uart", LIVE_TOPIC_UART}
+};
+
+static uint8_t parseTopics(const char* list, size_t len) {
+    uint8_t topics = 0;
+    size_t start = 0;
+    for (size_t i = 0; i <= len; i++) {
+        if (i < len && list[i] != ',') continue;
+        for (const auto& topic : topicNames) {
+            size_t n = strlen(topic.name);
+            if (i - start == n && memcmp(list + start, topic.name, n) == 0) topics |= topic.bit;
+        }
+        start = i + 1;
+    }
+    return topics;
+}
+
+// Aynı bağlantının eski kaydı, boş ya da süresi geçmiş kayıt kullanılır; yer yoksa false
+static bool stashPending(AsyncClient* conn, uint32_t session) {
+    PendingSocket* target = nullptr;
+    for (auto& entry : pendingSockets) {
+        if (entry.conn == conn) {
+            target = &entry;
+            break;
+        }
+        if (!target && (entry.conn == nullptr || millis() - entry.at > LIVE_HANDOFF_MS)) target = &entry;
+    }
+    if (!target) return false;
+    *target = {conn, session, millis()};
+    return true;
+}
+
+static uint32_t takePending(AsyncClient* conn) {
+    for (auto& entry : pendingSockets) {
+        if (entry.conn != conn) continue;
+        entry.conn = nullptr;
+        return entry.session;
+    }
+    return 0;
+}
+
+static void addClient(AsyncWebSocketClient* client) {
+    uint32_t session = takePending(client->client());
+    bool added = false;
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; session != 0 && i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        if (clients[i].client == nullptr) {
+            clients[i] = {client, session, 0, 0, false, false};
+            added = true;
+            break;
+        }
+    }
+    xSemaphoreGive(clientMutex);
+    if (!added) client->close();
+}
+
+static void removeClient(AsyncWebSocketClient* client) {
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        if (clients[i].client == client) clients[i].client = nullptr;
+    }
+    xSemaphoreGive(clientMutex);
+}
+
+static void setTopics(AsyncWebSocketClient* client, uint8_t topics) {
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        if (clients[i].client != client || clients[i].ended) continue;
+        // Yeni durum abonesi önce tam görüntüyü alır
+        if ((topics & LIVE_TOPIC_STATUS) && !(clients[i].topics & LIVE_TOPIC_STATUS)) clients[i].fullStatus = true;
+        clients[i].topics = topics;
+        clients[i].missed = 0;
+    }
+    xSemaphoreGive(clientMutex);
+}
+
+// AsyncTCP görevinde çalışır: oturumu sona eren istemciler burada kapatılır. Kapatma
+// olay işleyicisini hemen çağırabildiği için kilit bırakıldıktan sonra yapılır.
+// Kalan istemci sayısını döndürür.
+static int closeEndedClients() {
+    AsyncWebSocketClient* ended[LIVE_SOCKET_MAX_CLIENTS];
+    int endedCount = 0;
+    int active = 0;
+
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        if (!clients[i].client) continue;
+        if (clients[i].ended) {
+            ended[endedCount++] = clients[i].client;
+            clients[i].client = nullptr;
+        } else {
+            active++;
+        }
+    }
+    xSemaphoreGive(clientMutex);
+
+    for (int i = 0; i < endedCount; i++) ended[i]->close();
+    return active;
+}
+
+// AsyncTCP görevinde çalışır
+static void onLiveEvent(AsyncWebSocket* ws, AsyncWebSocketClient* client, AwsEventType type,
+                        void* arg, uint8_t* data, size_t len) {
+    switch (type) {
+        case WS_EVT_CONNECT:
+            addClient(client);
+            break;
+        case WS_EVT_DISCONNECT:
+            removeClient(client);
+            break;
+        case WS_EVT_PONG:
+            closeEndedClients();
+            break;
+        case WS_EVT_DATA: {
+            closeEndedClients();
+            // Yalnızca tek parçalık kısa metin komutları
+            AwsFrameInfo* info = (AwsFrameInfo*)arg;
+            if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_TEXT) return;
+            if (len > 4 && memcmp(data, "sub:", 4) == 0) {
+                setTopics(client, parseTopics((const char*)data + 4, len - 4));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void setupLiveSocket() {
+    arena.begin(arenaMemory, sizeof(arenaMemory));
+    clientMutex = xSemaphoreCreateMutex();
+
+    // Reddedilen istek sıradaki "/ws" rotasına düşer ve orada yanıtlanır
+    liveSocket.setFilter([](AsyncWebServerRequest* request) {
+        if (closeEndedClients() >= LIVE_SOCKET_MAX_CLIENTS) return false;
+        uint32_t session = getSessionId(request);
+        return session != 0 && stashPending(request->client(), session);
+    });
+    liveSocket.onEvent(onLiveEvent);
+    server.addHandler(&liveSocket);
+}
+
+void handleLiveSocketAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    sendJsonError(request, 503, "Çok fazla canlı bağlantı");
+}
+
+// {"t":"<konu>","d":<belge>}
+static size_t wrapMessage(const char* topic, JsonDocument& doc) {
+    if (doc.overflowed()) return 0;    // Bölgeye sığmayan belge yarım gönderilmez
+    int prefix = snprintf(message, sizeof(message), "{\"t\":\"%s\",\"d\":", topic);
+    size_t length = measureJson(doc);
+    if (prefix + length + 2 > sizeof(message)) return 0;
+    serializeJson(doc, message + prefix, sizeof(message) - prefix);
+    message[prefix + length] = '}';
+    message[prefix + length + 1] = '\0';
+    return prefix + length + 1;
+}
+
+static void sendTo(AsyncWebSocketClient* client, size_t len) {
+    client->text(std::make_shared<std::vector<uint8_t>>((const uint8_t*)message, (const uint8_t*)message + len));
+}
+
+// Mesaj bir kez kopyalanır, aynı tampon konunun tüm abonelerine paylaştırılır
+static void publish(uint8_t topic, size_t len) {
+    if (len == 0) return;
+
+    AsyncWebSocketSharedBuffer buffer;
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        AsyncWebSocketClient* client = clients[i].client;
+        if (!client || clients[i].ended || !(clients[i].topics & topic)) continue;
+
+        if (client->queueIsFull()) {
+            clients[i].missed |= topic;
+            droppedCount++;
+            continue;
+        }
+        if (!buffer) {
+            buffer = std::make_shared<std::vector<uint8_t>>((const uint8_t*)message, (const uint8_t*)message + len);
+        }
+        client->text(buffer);
+    }
+    xSemaphoreGive(clientMutex);
+}
+
+static uint8_t subscribedTopics() {
+    uint8_t topics = 0;
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        if (clients[i].client && !clients[i].ended) topics |= clients[i].topics;
+    }
+    xSemaphoreGive(clientMutex);
+    return topics;
+}
+
+static void publishStatus() {
+    uint32_t version = getStatusVersion();
+    if (version != publishedStatus) {
+        arena.reset();
+        JsonDocument doc(&arena);
+        writeStatusSnapshot(doc, publishedStatus);
+        publish(LIVE_TOPIC_STATUS, wrapMessage("status", doc));
+        publishedStatus = version;
+    }
+
+    // Yeni abone ya da mesaj kaçıran istemci: tek başına tam görüntü
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        AsyncWebSocketClient* client = clients[i].client;
+        if (!client || clients[i].ended || !clients[i].fullStatus || client->queueIsFull()) continue;
+
+        arena.reset();
+        JsonDocument doc(&arena);
+        writeStatusSnapshot(doc, 0);
+        size_t len = wrapMessage("status", doc);
+        if (len) sendTo(client, len);
+        clients[i].fullStatus = false;
+    }
+    xSemaphoreGive(clientMutex);
+}
+
+static void publishLogs(bool subscribed) {
+    logStoreLock();
+    uint32_t newest = logStoreNewestSeq();
+
+    if (!subscribed || logEpoch != logStoreEpoch()) {
+        // Abone yok ya da loglar temizlendi: yalnızca yenileri yayınla
+        logEpoch = logStoreEpoch();
+        logCursor = newest;
+        logStoreUnlock();
+        return;
+    }
+
+    if (newest - logCursor > LIVE_LOG_MAX_BACKLOG) {
+        // Çok geride kalındı: atla, abonelere resync bildir
+        logCursor = newest - LIVE_LOG_MAX_BACKLOG;
+        xSemaphoreTake(clientMutex, portMAX_DELAY);
+        for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+            if (clients[i].topics & LIVE_TOPIC_LOG) clients[i].missed |= LIVE_TOPIC_LOG;
+        }
+        xSemaphoreGive(clientMutex);
+    }
+
+    for (int sent = 0; sent < LIVE_LOG_BATCH && logCursor < newest; sent++) {
+        const LogRecord* rec = logStoreGet(++logCursor);
+        if (!rec) continue;
+        int prefix = snprintf(message, sizeof(message), "{\"t\":\"log\",\"d\":");
+        size_t len = formatLogRecordJson(*rec, message + prefix, sizeof(message) - prefix - 1);
+        if (len == 0) continue;
+        message[prefix + len] = '}';
+        message[prefix + len + 1] = '\0';
+        publish(LIVE_TOPIC_LOG, prefix + len + 1);
+    }
+    logStoreUnlock();
+}
+
+static void publishTick(uint8_t topics) {
+    if (topics & LIVE_TOPIC_TIME) {
+        arena.reset();
+        JsonDocument doc(&arena);
+        char datetime[LOG_TIMESTAMP_LEN];
+        if (!getCachedTimestamp(datetime, sizeof(datetime))) datetime[0] = '\0';
+        doc["datetime"] = (char*)datetime;
+        doc["uptime"] = millis() / 1000;
+        publish(LIVE_TOPIC_TIME, wrapMessage("time", doc));
+    }
+
+    // UART sağlığı yalnızca değiştiğinde
+    const UARTStats& stats = getUARTStats();
+    if ((topics & LIVE_TOPIC_UART) && (stats.totalCommands != lastUartTotal || isUARTHealthy() != lastUartHealthy)) {
+        lastUartTotal = stats.totalCommands;
+        lastUartHealthy = isUARTHealthy();
+
+        arena.reset();
+        JsonDocument doc(&arena);
+        doc["healthy"] = lastUartHealthy;
+        doc["total"] = stats.totalCommands;
+        doc["ok"] = stats.successfulCommands;
+        doc["failed"] = stats.failedCommands;
+        doc["errors"] = getUARTErrorCount();
+        publish(LIVE_TOPIC_UART, wrapMessage("uart", doc));
+    }
+}
+
+// Kuyruğu boşalan istemciye kaçırdığı konular bildirilir; kendisi HTTP ile tamamlar
+static void sendResyncs() {
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        AsyncWebSocketClient* client = clients[i].client;
+        uint8_t missed = clients[i].missed;
+        if (!client || clients[i].ended || !missed || client->queueIsFull()) continue;
+
+        if (missed & LIVE_TOPIC_STATUS) {
+            clients[i].fullStatus = true;
+            missed &= ~LIVE_TOPIC_STATUS;
+        }
+        if (missed) {
+            arena.reset();
+            JsonDocument doc(&arena);
+            JsonArray list = doc.to<JsonArray>();
+            for (const auto& topic : topicNames) {
+                if (missed & topic.bit) list.add(topic.name);
+            }
+            size_t len = wrapMessage("resync", doc);
+            if (len) sendTo(client, len);
+        }
+        clients[i].missed = 0;
+    }
+    xSemaphoreGive(clientMutex);
+}
+
+// Oturumu sona eren (çıkış, zaman aşımı) istemciye bildirilir ve gönderim durur; tarayıcı
+// soketi kendisi kapatır, kapatmazsa AsyncTCP tarafındaki sonraki olayda kapatılır
+static void markEndedSessions() {
+    static const char ended[] = "{\"t\":\"ended\"}";
+    xSemaphoreTake(clientMutex, portMAX_DELAY);
+    for (int i = 0; i < LIVE_SOCKET_MAX_CLIENTS; i++) {
+        AsyncWebSocketClient* client = clients[i].client;
+        if (!client || clients[i].ended || isSessionActive(clients[i].session)) continue;
+        client->text(ended, sizeof(ended) - 1);
+        clients[i].ended = true;
+        clients[i].topics = 0;
+    }
+    xSemaphoreGive(clientMutex);
+}
+
+void pumpLiveSocket() {
+    if (liveSocket.count() == 0) {
+        publishedStatus = getStatusVersion();
+        publishLogs(false);
+        return;
+    }
+
+    markEndedSessions();
+
+    uint8_t topics = subscribedTopics();
+    if (topics & LIVE_TOPIC_STATUS) {
+        publishStatus();
+    } else {
+        publishedStatus = getStatusVersion();
+    }
+    publishLogs(topics & LIVE_TOPIC_LOG);
+
+    uint32_t second = millis() / 1000;
+    if (second != lastTickSecond) {
+        lastTickSecond = second;
+        publishTick(topics);
+        sendResyncs();
+    }
+}
+
+// Arıza yanıtı alındığında (ertelenmiş iş, loop()) tüm abonelere
+void publishFaultEvent(const String& response, bool isFirst) {
+    if (liveSocket.count() == 0) return;
+
+    arena.reset();
+    JsonDocument doc(&arena);
+    doc["first"] = isFirst;
+    doc["response"] = response;
+    publish(LIVE_TOPIC_FAULT, wrapMessage("fault", doc));
+}
+
+int getLiveSocketClientCount() {
+    return liveSocket.count();
+}
+
+uint32_t getLiveSocketDroppedCount() {
+    return droppedCount;
+}
@@ -0,0 +1,309 @@
+#include "log_store.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <time.h>
+#include <algorithm>
+
+// Kayıtlar seq % capacity konumunda tutulur; bir seq'in hâlâ geçerli
+// olup olmadığı yalnızca en eski seq ile karşılaştırılarak anlaşılır.
+static LogRecord* records = nullptr;
+static uint32_t capacity = 0;
+static bool inPsram = false;
+
+static uint32_t newestSeq = 0;   // Hiç sıfırlanmaz; açılışta rastgele tabandan başlar
+static uint32_t storedCount = 0;
+static uint32_t storeEpoch = 0;  // Açılışta rastgele, her temizlemede artar
+static SemaphoreHandle_t storeMutex = nullptr;
+
+// İkincil indeksler: her seviye ve kaynak için en yeni kaydın seq'i.
+// Kayıtlardaki prevSame* alanları ile geriye doğru zincir oluşur.
+static uint32_t levelHead[LOG_LEVEL_COUNT];
+static uint32_t levelTotals[LOG_LEVEL_COUNT];
+static uint32_t sourceHead[LOG_STORE_MAX_SOURCES];
+static char sourceNames[LOG_STORE_MAX_SOURCES][LOG_STORE_SOURCE_LEN];
+static int sourceCount = 0;
+
+// Zaman indeksi: her dolu kovanın ilk kaydı (uptime'a göre artan sırada)
+struct TimeBucket {
+    uint32_t bucket;
+    uint32_t firstSeq;
+};
+
+static TimeBucket buckets[LOG_STORE_BUCKETS];
+static int bucketHead = 0;
+static int bucketCount = 0;
+
+static inline LogRecord& slotFor(uint32_t seq) {
+    return records[seq % capacity];
+}
+
+static inline bool isLive(uint32_t seq) {
+    return seq != 0 && seq <= newestSeq && seq >= logStoreOldestSeq();
+}
+
+static inline const TimeBucket& bucketAt(int index) {
+    return buckets[(bucketHead - bucketCount + index + LOG_STORE_BUCKETS) % LOG_STORE_BUCKETS];
+}
+
+static void resetIndexes() {
+    storedCount = 0;
+    bucketHead = 0;
+    bucketCount = 0;
+    memset(levelHead, 0, sizeof(levelHead));
+    memset(sourceHead, 0, sizeof(sourceHead));
+}
+
+bool initLogStore() {
+    if (records) return true;
+
+    storeMutex = xSemaphoreCreateRecursiveMutex();
+
+    if (psramFound()) {
+        records = (LogRecord*)ps_calloc(LOG_STORE_CAPACITY, sizeof(LogRecord));
+        if (records) {
+            capacity = LOG_STORE_CAPACITY;
+            inPsram = true;
+        }
+    }
+
+    if (!records) {
+        records = (LogRecord*)calloc(LOG_STORE_FALLBACK_CAPACITY, sizeof(LogRecord));
+        if (!records) return false;
+        capacity = LOG_STORE_FALLBACK_CAPACITY;
+        inPsram = false;
+    }
+
+    // Önceki açılıştan kalan imleç ve epoch yeni aralıkla karışmasın. Taban 2^30'un
+    // altında tutulur: seq taşmadan milyarlarca kayıt eklenebilir, 0 "yok" olarak kalır.
+    newestSeq = (esp_random() >> 2) | 1;
+    storeEpoch = esp_random();
+
+    // Son kaynak girdisi tablo dolduğunda ortak kullanılır
+    strcpy(sourceNames[LOG_STORE_MAX_SOURCES - 1], "OTHER");
+    resetIndexes();
+    return true;
+}
+
+void logStoreLock() {
+    if (storeMutex) xSemaphoreTakeRecursive(storeMutex, portMAX_DELAY);
+}
+
+void logStoreUnlock() {
+    if (storeMutex) xSemaphoreGiveRecursive(storeMutex);
+}
+
+static uint8_t internSource(const char* name) {
+    for (int i = 0; i < sourceCount; i++) {
+        if (strncmp(sourceNames[i], name, LOG_STORE_SOURCE_LEN - 1) == 0) return i;
+    }
+    if (sourceCount < LOG_STORE_MAX_SOURCES - 1) {
+        strncpy(sourceNames[sourceCount], name, LOG_STORE_SOURCE_LEN - 1);
+        sourceNames[sourceCount][LOG_STORE_SOURCE_LEN - 1] = '\0';
+        return sourceCount++;
+    }
+    return LOG_STORE_MAX_SOURCES - 1;
+}
+
+// Mesajı sığdır; çok baytlı UTF-8 karakterini ortadan bölme
+static uint8_t copyMessage(char* dest, const String& msg) {
+    size_t len = msg.length();
+    if (len > LOG_STORE_MESSAGE_LEN - 1) {
+        len = LOG_STORE_MESSAGE_LEN - 1;
+        while (len > 0 && ((uint8_t)msg[len] & 0xC0) == 0x80) len--;
+    }
+    memcpy(dest, msg.c_str(), len);
+    dest[len] = '\0';
+    return (uint8_t)len;
+}
+
+uint32_t logStoreAppend(const String& msg, LogLevel level, const String& source) {
+    if (!records) return 0;
+    if ((unsigned)level >= LOG_LEVEL_COUNT) level = INFO;
+
+    uint32_t seq = ++newestSeq;
+    uint8_t sourceId = internSource(source.c_str());
+    LogRecord& rec = slotFor(seq);
+
+    rec.seq = seq;
+    rec.millis_time = millis();
+    rec.uptime = (uint32_t)(esp_timer_get_time() / 1000000ULL);
+    time_t now = time(nullptr);
+    rec.wallTime = now > 1577836800 ? (uint32_t)now : 0; // 2020 öncesi = ayarlanmamış saat
+    rec.level = (uint8_t)level;
+    rec.sourceId = sourceId;
+    rec.length = copyMessage(rec.message, msg);
+
+    rec.prevSameLevel = levelHead[level];
+    rec.prevSameSource = sourceHead[sourceId];
+    levelHead[level] = seq;
+    sourceHead[sourceId] = seq;
+    levelTotals[level]++;
+
+    if (storedCount < capacity) {
+        storedCount++;
+    }
+
+    // Yeni bir zaman kovasına geçildiyse indekse ekle
+    uint32_t bucket = rec.uptime / LOG_STORE_BUCKET_SECONDS;
+    if (bucketCount == 0 || bucketAt(bucketCount - 1).bucket != bucket) {
+        buckets[bucketHead].bucket = bucket;
+        buckets[bucketHead].firstSeq = seq;
+        bucketHead = (bucketHead + 1) % LOG_STORE_BUCKETS;
+        if (bucketCount < LOG_STORE_BUCKETS) {
+            bucketCount++;
+        }
+    }
+
+    return seq;
+}
+
+void logStoreClear() {
+    resetIndexes();
+    storeEpoch++;
+}
+
+const LogRecord* logStoreGet(uint32_t seq) {
+    if (!records || !isLive(seq)) return nullptr;
+    return &slotFor(seq);
+}
+
+// İlk kova >= hedef olan konum (ikili arama)
+static int lowerBoundBucket(uint32_t target) {
+    int lo = 0, hi = bucketCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (bucketAt(mid).bucket < target) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// uptime'ı >= verilen değer olan ilk kayıt. Kova aralığı daraltır; uptime seq ile
+// birlikte arttığı için aralık içinde ikili arama yapılır (kova penceresi dışında da).
+static uint32_t firstSeqAtOrAfter(uint32_t uptime) {
+    int idx = lowerBoundBucket(uptime / LOG_STORE_BUCKET_SECONDS);
+    if (idx == bucketCount) return newestSeq + 1;
+
+    uint32_t oldest = logStoreOldestSeq();
+    uint32_t lo = (idx == 0) ? oldest : std::max(bucketAt(idx).firstSeq, oldest);
+    uint32_t hi = (idx + 1 < bucketCount) ? bucketAt(idx + 1).firstSeq : newestSeq + 1;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (slotFor(mid).uptime < uptime) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// uptime'ı <= verilen değer olan son kayıt
+static uint32_t lastSeqAtOrBefore(uint32_t uptime) {
+    if (uptime == UINT32_MAX) return newestSeq;
+    return firstSeqAtOrAfter(uptime + 1) - 1;
+}
+
+// Sonuçlar 'out' dizisine artan seq sırasıyla yazılır (en fazla query.limit).
+// sinceSeq verilmişse aralığın en eski kayıtları, verilmemişse en yenileri döner.
+// Filtreli sorgular yalnızca ilgili seviye/kaynak zincirindeki kayıtları gezer.
+int logStoreQuery(const LogQuery& query, uint32_t* out, bool* more) {
+    *more = false;
+    if (!records || storedCount == 0 || query.limit <= 0) return 0;
+
+    uint32_t lo = logStoreOldestSeq();
+    uint32_t hi = newestSeq;
+    if (query.sinceSeq >= lo) lo = query.sinceSeq + 1;
+    if (query.beforeSeq > 0 && query.beforeSeq <= hi) hi = query.beforeSeq - 1;
+    if (query.fromUptime > 0) lo = std::max(lo, firstSeqAtOrAfter(query.fromUptime));
+    if (query.toUptime > 0) hi = std::min(hi, lastSeqAtOrBefore(query.toUptime));
+    if (hi == 0 || lo > hi) return 0;
+
+    bool ascending = query.sinceSeq > 0;
+    uint32_t limit = (uint32_t)query.limit;
+
+    // Filtre yok: seq'ler ardışık, doğrudan hesaplanır
+    if (query.level < 0 && query.sourceId < 0) {
+        uint32_t total = hi - lo + 1;
+        uint32_t n = std::min(total, limit);
+        uint32_t start = ascending ? lo : hi - n + 1;
+        for (uint32_t i = 0; i < n; i++) {
+            out[i] = start + i;
+        }
+        *more = total > n;
+        return (int)n;
+    }
+
+    // Kaynak zinciri genelde daha seçicidir; seviye ek koşul olarak kontrol edilir
+    bool useSource = query.sourceId >= 0 && query.sourceId < LOG_STORE_MAX_SOURCES;
+    if (!useSource && (query.level < 0 || query.level >= LOG_LEVEL_COUNT)) return 0;
+    uint32_t seq = useSource ? sourceHead[query.sourceId] : levelHead[query.level];
+
+    uint32_t matched = 0;
+    uint32_t writePos = 0;
+    while (isLive(seq) && seq >= lo) {
+        const LogRecord& rec = slotFor(seq);
+        bool match = seq <= hi && (!useSource || query.level < 0 || rec.level == (uint8_t)query.level);
+        if (match) {
+            if (ascending) {
+                // Geriye yürürken son 'limit' eşleşme aralığın en eskileridir
+                out[writePos] = seq;
+                writePos = (writePos + 1) % limit;
+                matched++;
+            } else if (matched < limit) {
+                out[matched++] = seq;
+            } else {
+                *more = true;
+                break;
+            }
+        }
+        seq = useSource ? rec.prevSameSource : rec.prevSameLevel;
+    }
+
+    uint32_t n = std::min(matched, limit);
+    if (ascending && matched > limit) {
+        std::rotate(out, out + writePos, out + limit);
+        *more = true;
+    }
+    std::reverse(out, out + n);
+    return (int)n;
+}
+
+uint32_t logStoreNewestSeq() {
+    return newestSeq;
+}
+
+uint32_t logStoreOldestSeq() {
+    return newestSeq - storedCount + 1;
+}
+
+uint32_t logStoreCount() {
+    return storedCount;
+}
+
+uint32_t logStoreCapacity() {
+    return capacity;
+}
+
+uint32_t logStoreEpoch() {
+    return storeEpoch;
+}
+
+uint32_t logStoreLevelTotal(LogLevel level) {
+    if ((unsigned)level >= LOG_LEVEL_COUNT) return 0;
+    return levelTotals[level];
+}
+
+bool logStoreInPsram() {
+    return inPsram;
+}
+
+int logStoreFindSource(const String& name) {
+    for (int i = 0; i < sourceCount; i++) {
+        if (strncmp(sourceNames[i], name.c_str(), LOG_STORE_SOURCE_LEN - 1) == 0) return i;
+    }
+    return -1;
+}
+
+const char* logStoreSourceName(uint8_t id) {
+    if (id >= LOG_STORE_MAX_SOURCES) return "";
+    return sourceNames[id];
+}
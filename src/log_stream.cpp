@@ -0,0 +1,262 @@
+#include "log_stream.h"
+#include "log_store.h"
+#include "log_system.h"
+#include "auth_system.h"
+#include "settings.h"
+#include "http_server.h"
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Server-Sent Events ile canlı log akışı. Her izleyicinin kendi imleci vardır: loop()
+// her istemciye kaldığı yerden gönderir, kuyruğu dolu istemci o tur atlanır ve yalnızca
+// o istemci geride kalır. Çok geride kalan istemciye atlanan kayıt sayısı bildirilir.
+static AsyncEventSource logEvents("/api/logs/stream");
+
+static uint32_t broadcastEpoch = 0;
+
+// Filtreden onConnect'e aktarılan oturum ve since, bağlantı (AsyncClient) anahtarıyla:
+// iki isteğin filtre ve bağlantı adımları araya girse de her soket kendi isteğinin
+// oturumunu alır. Yalnızca AsyncTCP görevinde kullanılır.
+struct PendingStream {
+    AsyncClient* conn;
+    uint32_t session;
+    uint32_t since;
+    unsigned long at;
+};
+static PendingStream pendingStreams[LOG_STREAM_MAX_CLIENTS];
+
+// İzleyici durumu. Kütüphane istemciyi onDisconnect döndükten sonra siler; onDisconnect
+// streamMutex'i beklediği için kilit tutulurken loop()'tan istemciye gönderim güvenlidir.
+struct StreamClient {
+    AsyncEventSourceClient* client;
+    uint32_t session;
+    uint32_t cursor;                   // Bu istemciye gönderilen son kaydın seq'i
+    unsigned long lastSend;
+    bool ended;                        // Oturum sona erdi: bildirildi, AsyncTCP tarafında kapatılacak
+};
+static StreamClient streamClients[LOG_STREAM_MAX_CLIENTS];
+static SemaphoreHandle_t streamMutex = nullptr;
+
+// Kayıt belgeleri için sabit bölge: formatLogRecordJson yalnızca log deposu kilitliyken çağrılır
+static uint8_t recordMemory[HTTP_STREAM_ARENA_SIZE];
+static JsonArena recordArena;
+
+size_t formatLogRecordJson(const LogRecord& rec, char* out, size_t size) {
+    if (recordArena.capacity() == 0) recordArena.begin(recordMemory, sizeof(recordMemory));
+    recordArena.reset();
+    JsonDocument doc(&recordArena);
+    char timestamp[LOG_TIMESTAMP_LEN];
+    formatLogTimestamp(rec.wallTime, rec.millis_time, timestamp, sizeof(timestamp));
+    doc["seq"] = rec.seq;
+    doc["timestamp"] = (char*)timestamp;
+    doc["message"] = rec.message;
+    doc["level"] = logLevelName((LogLevel)rec.level);
+    doc["source"] = logStoreSourceName(rec.sourceId);
+    doc["millis"] = rec.millis_time;
+    if (doc.overflowed()) return 0;
+
+    size_t len = serializeJson(doc, out, size);
+    return len < size ? len : 0;
+}
+
+static void sendDropped(AsyncEventSourceClient* client, uint32_t skipped) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%lu", (unsigned long)skipped);
+    client->send(buf, "dropped");
+}
+
+// Aynı bağlantının eski kaydı, boş ya da süresi geçmiş kayıt kullanılır; yer yoksa false
+static bool stashPending(AsyncClient* conn, uint32_t session, uint32_t since) {
+    PendingStream* target = nullptr;
+    for (auto& entry : pendingStreams) {
+        if (entry.conn == conn) {
+            target = &entry;
+            break;
+        }
+        if (!target && (entry.conn == nullptr || millis() - entry.at > LOG_STREAM_HANDOFF_MS)) target = &entry;
+    }
+    if (!target) return false;
+    *target = {conn, session, since, millis()};
+    return true;
+}
+
+static bool takePending(AsyncClient* conn, uint32_t& session, uint32_t& since) {
+    for (auto& entry : pendingStreams) {
+        if (entry.conn != conn) continue;
+        session = entry.session;
+        since = entry.since;
+        entry.conn = nullptr;
+        return true;
+    }
+    return false;
+}
+
+// AsyncTCP görevinde çalışır: istemci kaydedilir, eksik kayıtları loop() kaldığı yerden gönderir
+static void onStreamConnect(AsyncEventSourceClient* client) {
+    uint32_t session, since;
+    if (!takePending(client->client(), session, since)) {
+        client->close();
+        return;
+    }
+
+    logStoreLock();
+    uint32_t newest = logStoreNewestSeq();
+    uint32_t oldest = logStoreOldestSeq();
+    logStoreUnlock();
+
+    // Önce tarayıcının Last-Event-ID başlığı, sonra since parametresi. Seq her açılışta
+    // rastgele tabandan başladığı için olay kimliği açılışı da taşır: önceki açılışın
+    // kimliği bu açılışın aralığına (oldest - 1 .. newest) düşmez.
+    uint32_t cursor = client->lastId() ? client->lastId() : since;
+    if (cursor > newest || (cursor != 0 && cursor + 1 < oldest)) {
+        // Cihaz yeniden başladı ya da kayıtlar silindi: istemci listesini sıfırlasın
+        client->send("{}", "reset", 0, LOG_STREAM_RETRY_MS);
+        cursor = newest;
+    } else {
+        client->send("{}", "ready", 0, LOG_STREAM_RETRY_MS);
+        if (cursor == 0) cursor = newest;   // İlk açılış: geçmiş REST ile alınır
+    }
+
+    bool added = false;
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    for (auto& entry : streamClients) {
+        if (entry.client == nullptr) {
+            entry = {client, session, cursor, millis(), false};
+            added = true;
+            break;
+        }
+    }
+    xSemaphoreGive(streamMutex);
+    if (!added) {
+        client->close();
+        return;
+    }
+
+    addLog("Canlı log izleyicisi bağlandı (" + String(getLogStreamClientCount()) + "/" +
+           String(LOG_STREAM_MAX_CLIENTS) + ")", DEBUG, "WEB");
+}
+
+static void onStreamDisconnect(AsyncEventSourceClient* client) {
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    for (auto& entry : streamClients) {
+        if (entry.client == client) entry.client = nullptr;
+    }
+    xSemaphoreGive(streamMutex);
+}
+
+// AsyncTCP görevinde (filtre) çalışır: oturumu sona eren izleyiciler burada kapatılır,
+// kütüphane istemciyi loop()'tan kapatmaya izin vermez. Kapatma onDisconnect'i hemen
+// çağırabildiği için kilit bırakıldıktan sonra yapılır. Kalan izleyici sayısını döndürür.
+static int closeEndedStreams() {
+    AsyncEventSourceClient* ended[LOG_STREAM_MAX_CLIENTS];
+    int endedCount = 0;
+    int active = 0;
+
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+    for (auto& entry : streamClients) {
+        if (!entry.client) continue;
+        if (entry.ended) {
+            ended[endedCount++] = entry.client;
+            entry.client = nullptr;
+        } else {
+            active++;
+        }
+    }
+    xSemaphoreGive(streamMutex);
+
+    for (int i = 0; i < endedCount; i++) ended[i]->close();
+    return active;
+}
+
+// Tek istemciye en fazla LOG_STREAM_BATCH kayıt; kuyruğu doluysa bu tur atlanır.
+// Log deposu ve streamMutex kilitliyken çağrılır.
+static void pumpClient(StreamClient& entry, uint32_t newest, char* buf, size_t size) {
+    if (entry.client->packetsWaiting() >= LOG_STREAM_MAX_QUEUED) return;
+
+    uint32_t lag = newest - entry.cursor;
+    if (lag > LOG_STREAM_MAX_BACKLOG) {
+        uint32_t skipped = lag - LOG_STREAM_MAX_BACKLOG;
+        entry.cursor += skipped;
+        sendDropped(entry.client, skipped);
+    }
+
+    for (int sent = 0; sent < LOG_STREAM_BATCH && entry.cursor < newest; sent++) {
+        const LogRecord* rec = logStoreGet(++entry.cursor);
+        if (rec && formatLogRecordJson(*rec, buf, size)) {
+            entry.client->send(buf, "log", rec->seq);
+            entry.lastSend = millis();
+        }
+    }
+
+    // Boşta kalan bağlantıyı canlı tut
+    if (millis() - entry.lastSend > LOG_STREAM_HEARTBEAT_MS) {
+        entry.client->send("{}", "ping");
+        entry.lastSend = millis();
+    }
+}
+
+void setupLogStream() {
+    streamMutex = xSemaphoreCreateMutex();
+
+    // Reddedilen istek sıradaki "/api/logs/stream" rotasına düşer ve orada yanıtlanır
+    logEvents.setFilter([](AsyncWebServerRequest* request) {
+        if (closeEndedStreams() >= LOG_STREAM_MAX_CLIENTS) return false;
+        uint32_t session = getSessionId(request);
+        if (session == 0) return false;
+        return stashPending(request->client(), session, strtoul(request->arg("since").c_str(), nullptr, 10));
+    });
+    logEvents.onConnect(onStreamConnect);
+    logEvents.onDisconnect(onStreamDisconnect);
+    server.addHandler(&logEvents);
+}
+
+void handleLogStreamAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    sendJsonError(request, 503, "Çok fazla canlı log izleyicisi");
+}
+
+void pumpLogStreams() {
+    logStoreLock();
+    uint32_t newest = logStoreNewestSeq();
+    uint32_t epoch = logStoreEpoch();
+    bool cleared = broadcastEpoch != epoch;
+    broadcastEpoch = epoch;
+
+    if (logEvents.count() == 0) {
+        logStoreUnlock();
+        return;
+    }
+
+    xSemaphoreTake(streamMutex, portMAX_DELAY);
+
+    char buf[LOG_STREAM_BUFFER_SIZE];
+    for (auto& entry : streamClients) {
+        if (!entry.client || entry.ended) continue;
+
+        // Oturumu sona eren izleyiciye bildirilir ve gönderim durur; tarayıcı akışı kendisi
+        // kapatır, kapatmazsa bağlantı sonraki filtrede AsyncTCP tarafında kapatılır
+        if (!isSessionActive(entry.session)) {
+            entry.client->send("{}", "ended");
+            entry.ended = true;
+            continue;
+        }
+
+        if (cleared) {
+            // Loglar temizlendi
+            entry.client->send("{}", "reset");
+            entry.cursor = logStoreOldestSeq() - 1;
+        }
+        pumpClient(entry, newest, buf, sizeof(buf));
+    }
+
+    xSemaphoreGive(streamMutex);
+    logStoreUnlock();
+}
+
+int getLogStreamClientCount() {
+    return logEvents.count();
+}
@@ -1,69 +1,139 @@
 #include "log_system.h"
+#include "log_store.h"
+#include "crash_log.h"
+#include "system_clock.h"
 #include <time.h>
 
-// log_system.h'de 'extern' olarak bildirilen global değişkenlerin
-// gerçek tanımlamaları burada yapılır.
-LogEntry logs[50];
-int logIndex = 0;
-int totalLogs = 0;
+// Zaman damgası önbelleği: saniye değişince bir kez formatlanır. Okuyan görev yarım
+// yazılmış metin görmesin diye kontrol ve kopyalama tsMux altında yapılır.
+struct TimestampCache {
+    bool valid;
+    bool synced;
+    int timezone;
+    uint32_t second;        // Saat ayarlıysa epoch saniyesi, değilse uptime saniyesi
+    char dateTime[LOG_TIMESTAMP_LEN];   // "GG.AA.YYYY SS:DD:ss" veya "SS:DD:ss"
+    char date[12];
+    char time[12];
+};
+
+static TimestampCache tsCache = { false };
+static portMUX_TYPE tsMux = portMUX_INITIALIZER_UNLOCKED;
+
+enum TimestampPart { TS_DATE_TIME, TS_DATE, TS_TIME };
+
+static void formatUptime(unsigned long millisTime, char* out, size_t size) {
+    unsigned long seconds = millisTime / 1000;
+    snprintf(out, size, "%02lu:%02lu:%02lu", (seconds / 3600) % 24, (seconds / 60) % 60, seconds % 60);
+}
+
+// Biçimlendirme kilit dışında yapılır; kilit altında yalnızca karşılaştırma ve kopyalama
+static bool readTimestampCache(TimestampPart part, char* out, size_t size) {
+    bool synced = isClockSynced();
+    uint32_t second = synced ? (uint32_t)getClockTime() : millis() / 1000;
+    int timezone = getClockTimezone();
+
+    portENTER_CRITICAL(&tsMux);
+    bool fresh = tsCache.valid && tsCache.second == second && tsCache.synced == synced && tsCache.timezone == timezone;
+    portEXIT_CRITICAL(&tsMux);
+
+    TimestampCache next = { true, synced, timezone, second };
+    if (!fresh) {
+        if (synced) {
+            time_t t = (time_t)second + timezone * 3600;
+            struct tm timeinfo;
+            gmtime_r(&t, &timeinfo);
+            snprintf(next.date, sizeof(next.date), "%02d.%02d.%04d",
+                     timeinfo.tm_mday, timeinfo.tm_mon + 1, timeinfo.tm_year + 1900);
+            snprintf(next.time, sizeof(next.time), "%02d:%02d:%02d",
+                     timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+            snprintf(next.dateTime, sizeof(next.dateTime), "%s %s", next.date, next.time);
+        } else {
+            formatUptime(second * 1000UL, next.dateTime, sizeof(next.dateTime));
+        }
+    }
+
+    portENTER_CRITICAL(&tsMux);
+    if (!fresh) tsCache = next;
+    const char* source = part == TS_DATE ? tsCache.date : part == TS_TIME ? tsCache.time : tsCache.dateTime;
+    if (!synced && part != TS_DATE_TIME) source = "";
+    strncpy(out, source, size - 1);
+    out[size - 1] = '\0';
+    portEXIT_CRITICAL(&tsMux);
+    return synced;
+}
+
+bool getCachedTimestamp(char* out, size_t size) {
+    return readTimestampCache(TS_DATE_TIME, out, size);
+}
+
+bool getCachedDate(char* out, size_t size) {
+    return readTimestampCache(TS_DATE, out, size);
+}
+
+bool getCachedTime(char* out, size_t size) {
+    return readTimestampCache(TS_TIME, out, size);
+}
 
 // NTP'den geçerli zaman alınamazsa kullanılacak zaman formatı
 String getFormattedTimestampFallback() {
-    unsigned long seconds = millis() / 1000;
-    unsigned long minutes = seconds / 60;
-    unsigned long hours = minutes / 60;
-    seconds %= 60;
-    minutes %= 60;
-    hours %= 24;
-
     char buffer[16];
-    sprintf(buffer, "%02lu:%02lu:%02lu", hours, minutes, seconds);
+    formatUptime(millis(), buffer, sizeof(buffer));
     return String(buffer);
 }
 
-// NTP'den veya sistemden zamanı alıp formatlayan ana fonksiyon
-String getFormattedTimestamp() {
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo)) {
-        char buffer[32];
-        strftime(buffer, sizeof(buffer), "%d.%m.%Y %H:%M:%S", &timeinfo);
-        return String(buffer);
-    } else {
-        // NTP henüz senkronize olmamışsa, millis() kullan
-        return getFormattedTimestampFallback();
+// Depodaki bir kaydın zamanını formatla (duvar saati yoksa uptime)
+void formatLogTimestamp(uint32_t wallTime, uint32_t millisTime, char* out, size_t size) {
+    if (wallTime == 0) {
+        formatUptime(millisTime, out, size);
+        return;
     }
+
+    time_t t = wallTime + getClockTimezone() * 3600;
+    struct tm timeinfo;
+    gmtime_r(&t, &timeinfo);
+    strftime(out, size, "%d.%m.%Y %H:%M:%S", &timeinfo);
+}
+
+// Düzeltilmiş sistem saatinden zamanı alıp formatlayan ana fonksiyon
+// Saat henüz ayarlanmamışsa uptime döner
+String getFormattedTimestamp() {
+    char timestamp[LOG_TIMESTAMP_LEN];
+    getCachedTimestamp(timestamp, sizeof(timestamp));
+    return String(timestamp);
 }
 
 // Log sistemini başlatan fonksiyon
 void initLogSystem() {
-    for (int i = 0; i < 50; i++) {
-        logs[i].message = "";
-    }
-    logIndex = 0;
-    totalLogs = 0;
+    bool storeReady = initLogStore();
     // Sistem başlatıldığında ilk logu ekle
     addLog("Log sistemi başlatıldı.", INFO, "SYSTEM");
+    if (storeReady) {
+        addLog("Log deposu: " + String(logStoreCapacity()) + " kayıt (" +
+               (logStoreInPsram() ? "PSRAM" : "dahili RAM") + ")", INFO, "SYSTEM");
+    }
+
+    // Reset öncesi RTC bellekte kalan kayıtları aktar
+    importCrashLog();
 }
 
 // Yeni bir log ekleyen ana fonksiyon
 void addLog(const String& msg, LogLevel level, const String& source) {
-    logs[logIndex].timestamp = getFormattedTimestamp();
-    logs[logIndex].message = msg;
-    logs[logIndex].level = level;
-    logs[logIndex].source = source;
-    logs[logIndex].millis_time = millis();
-
-    logIndex = (logIndex + 1) % 50; // Dairesel arabellek mantığı
-    if (totalLogs < 50) {
-        totalLogs++;
-    }
+    // loop() ve web sunucusu görevi aynı anda log ekleyebilir
+    logStoreLock();
+    logStoreAppend(msg, level, source);
+
+    // Reset sonrası incelenebilmesi için RTC belleğe de yaz
+    crashLogRecord(msg, level, source);
 
-    // Seri monitöre de logu bas
-    Serial.println("[" + getFormattedTimestamp() + "] [" + logLevelToString(level) + "] [" + source + "] " + msg);
+    // Seri monitöre de logu bas (önbellekteki zaman damgası, geçici String yok)
+    char timestamp[LOG_TIMESTAMP_LEN];
+    getCachedTimestamp(timestamp, sizeof(timestamp));
+    Serial.printf("[%s] [%s] [%s] %s\n", timestamp, logLevelName(level), source.c_str(), msg.c_str());
+    logStoreUnlock();
 }
 
 // Log seviyesini string'e çeviren yardımcı fonksiyon
-String logLevelToString(LogLevel level) {
+const char* logLevelName(LogLevel level) {
     switch (level) {
         case ERROR: return "ERROR";
         case WARN:  return "WARN";
@@ -74,12 +144,24 @@ String logLevelToString(LogLevel level) {
     }
 }
 
+String logLevelToString(LogLevel level) {
+    return String(logLevelName(level));
+}
+
+bool logLevelFromString(const String& str, LogLevel& level) {
+    if (str == "ERROR") level = ERROR;
+    else if (str == "WARN") level = WARN;
+    else if (str == "INFO") level = INFO;
+    else if (str == "DEBUG") level = DEBUG;
+    else if (str == "SUCCESS") level = SUCCESS;
+    else return false;
+    return true;
+}
+
 // Tüm logları temizleyen fonksiyon
 void clearLogs() {
-    for (int i = 0; i < 50; i++) {
-        logs[i].message = "";
-    }
-    logIndex = 0;
-    totalLogs = 0;
+    logStoreLock();
+    logStoreClear();
+    logStoreUnlock();
     addLog("Log kayıtları temizlendi.", WARN, "SYSTEM");
 }
\ No newline at end of file
@@ -4,12 +4,22 @@
 #include "log_system.h"
 #include "uart_handler.h"
 #include "ntp_handler.h"
+#include "sntp_client.h"
 #include "web_routes.h"
+#include "crash_log.h"
+#include "log_stream.h"
+#include "syslog_forwarder.h"
+#include "http_server.h"
+#include "status_snapshot.h"
+#include "live_socket.h"
+#include "auth_system.h"
+#include "metrics_history.h"
 
 // Sistem durumu takibi için değişkenler
 unsigned long lastHeapCheck = 0;
 unsigned long lastStatusLog = 0;
 size_t minFreeHeap = SIZE_MAX;
+uint32_t ethLinkFlaps = 0;      // Bağlantının düşme sayısı
 
 // Watchdog timer için
 unsigned long lastWatchdogFeed = 0;
@@ -18,6 +28,9 @@ const unsigned long WATCHDOG_TIMEOUT = 30000; // 30 saniye
 void setup() {
   Serial.begin(115200);
   delay(100);
+
+  // Önceki açılışın RTC kayıtlarını al (flash erişimi gerektirmez)
+  initCrashLog();
   
   // Sistem başlangıç logu
   Serial.println("\n=== TEİAŞ EKLİM Cihazı Başlatılıyor ===");
@@ -42,6 +55,7 @@ void setup() {
     }
     
     // Sistem yeniden başlatılsın
+    crashLogNoteRestart("SPIFFS");
     ESP.restart();
     return;
   }
@@ -82,7 +96,15 @@ void setup() {
   initNTPHandler();
   Serial.println("BAŞARULI");
   
-  // 6. Web sunucusu ve rotalar
+  // 6. Syslog iletimi (isteğe bağlı)
+  Serial.print("Syslog başlatılıyor... ");
+  initSyslog();
+  Serial.println("BAŞARILI");
+  
+  // Gösterge paneli durumu (ayarlar ve NTP yüklendikten sonra)
+  initStatusSnapshot();
+  
+  // 7. Web sunucusu ve rotalar
   Serial.print("Web sunucusu başlatılıyor... ");
   setupWebRoutes();
   Serial.println("BAŞARILI");
@@ -108,6 +130,9 @@ void checkSystemHealth() {
     minFreeHeap = currentHeap;
   }
   
+  // Grafik geçmişi için 5 sn'lik örnek
+  sampleMetricsHistory();
+  
   // Heap kullanımı kritik seviyeye düştüyse uyar
   if (currentHeap < 20000) { // 20KB altında
     addLog("⚠️ UYARI: Düşük bellek! Free Heap: " + String(currentHeap), WARN, "SYSTEM");
@@ -116,6 +141,7 @@ void checkSystemHealth() {
   // Çok kritik durumda sistem yeniden başlat
   if (currentHeap < 10000) { // 10KB altında
     addLog("🔄 KRİTİK: Bellek tükendi! Sistem yeniden başlatılıyor...", ERROR, "SYSTEM");
+    crashLogNoteRestart("LOW_HEAP");
     delay(1000);
     ESP.restart();
   }
@@ -137,6 +163,7 @@ void feedWatchdog() {
 void checkWatchdog() {
   if (millis() - lastWatchdogFeed > WATCHDOG_TIMEOUT) {
     addLog("🔄 WATCHDOG: Sistem yanıt vermiyor! Yeniden başlatılıyor...", ERROR, "SYSTEM");
+    crashLogNoteRestart("WATCHDOG");
     delay(1000);
     ESP.restart();
   }
@@ -144,10 +171,16 @@ void checkWatchdog() {
 
 void loop() {
   unsigned long currentTime = millis();
+  uint32_t loopStart = micros();
   
-  // Ana işlemler
-  server.handleClient();
+  // Ana işlemler (HTTP istekleri AsyncTCP görevinde işlenir)
+  runDeferredRequests(); // Web isteklerinden ertelenen UART işleri
+  pumpLogStreams();      // Canlı log izleyicilerine yeni kayıtları gönder
+  pumpLiveSocket();      // WebSocket abonelerine değişenleri bir kez yayınla
   processReceivedData(); // NTP handler - arka porttan veri işleme
+  processSntpClient();   // Arka port susarsa SNTP ile saati sürdür
+  processSyslog();       // Uzak syslog sunucusuna toplu gönderim
+  updateStatusSnapshot(); // Gösterge paneli değerleri (saniyede bir)
   
   // Watchdog besleme
   feedWatchdog();
@@ -173,19 +206,14 @@ void loop() {
     if (currentEthStatus) {
       addLog("✅ Ethernet bağlantısı yeniden kuruldu.", SUCCESS, "ETH");
     } else {
+      ethLinkFlaps++;
       addLog("❌ Ethernet bağlantısı kesildi.", ERROR, "ETH");
     }
     lastEthStatus = currentEthStatus;
+    statusSetEthernet(currentEthStatus);
   }
   
-  // Session timeout kontrolü - aktif oturum varsa
-  if (settings.isLoggedIn) {
-    if (millis() - settings.sessionStartTime > settings.SESSION_TIMEOUT) {
-      settings.isLoggedIn = false;
-      addLog("Oturum otomatik olarak sonlandırıldı (timeout).", INFO, "AUTH");
-    }
-  }
-  
-  // CPU'ya nefes aldır - loop delay
+  // CPU'ya nefes aldır - loop delay (bekleme döngü süresine dahil değil)
+  noteLoopTime(micros() - loopStart);
   delay(10);
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "metrics_exporter.h"
+#include "http_server.h"
+#include "route_metrics.h"
+#include "rate_limiter.h"
+#include "uart_handler.h"
+#include "ntp_handler.h"
+#include "sntp_client.h"
+#include "system_clock.h"
+#include "log_system.h"
+#include "log_store.h"
+#include "log_stream.h"
+#include "live_socket.h"
+#include "syslog_forwarder.h"
+#include "auth_system.h"
+#include "settings.h"
+#include <new>
+#include <stdarg.h>
+
+extern size_t minFreeHeap;
+extern uint32_t ethLinkFlaps;
+extern Settings settings;
+
+// Üretim sırası; rota grupları her çağrıda tek rotanın satırlarını yazar
+enum MetricsStep {
+    STEP_SYSTEM = 0,
+    STEP_NETWORK,
+    STEP_UART,
+    STEP_BACKEND,
+    STEP_LOGS,
+    STEP_AUTH,
+    STEP_HTTP,
+    STEP_ROUTE_RESPONSES,
+    STEP_ROUTE_BYTES,
+    STEP_ROUTE_DURATION,
+    STEP_ROUTE_HANDLER,
+    STEP_DONE
+};
+
+// Üretim durumu isteğin belge bölgesinde tutulur; satırlar yuva tamponunda üretilir
+struct MetricsStream {
+    HttpSlot* slot;
+    int step = STEP_SYSTEM;
+    int route = -1;             // -1: grubun başlığı henüz yazılmadı
+    size_t len = 0;
+    size_t pos = 0;
+};
+
+// Tampona satır ekler; sığmayan satır kesilmez, atlanır
+static void put(MetricsStream& s, const char* format, ...) {
+    size_t room = s.slot->size - s.len;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(s.slot->buffer + s.len, room, format, args);
+    va_end(args);
+    if (n > 0 && (size_t)n < room) s.len += n;
+}
+
+static void family(MetricsStream& s, const char* name, const char* help, const char* type) {
+    put(s, "# HELP " METRICS_PREFIX "%s %s\n# TYPE " METRICS_PREFIX "%s %s\n", name, help, name, type);
+}
+
+static void gauge(MetricsStream& s, const char* name, const char* help, unsigned long long value) {
+    family(s, name, help, "gauge");
+    put(s, METRICS_PREFIX "%s %llu\n", name, value);
+}
+
+static void counter(MetricsStream& s, const char* name, const char* help, unsigned long long value) {
+    family(s, name, help, "counter");
+    put(s, METRICS_PREFIX "%s %llu\n", name, value);
+}
+
+static void writeSystem(MetricsStream& s) {
+    gauge(s, "uptime_seconds", "Seconds since boot.", millis() / 1000);
+    gauge(s, "heap_free_bytes", "Free heap.", ESP.getFreeHeap());
+    gauge(s, "heap_min_free_bytes", "Lowest free heap seen by the health check.", minFreeHeap == SIZE_MAX ? ESP.getFreeHeap() : minFreeHeap);
+    gauge(s, "heap_largest_free_block_bytes", "Largest allocatable heap block.", ESP.getMaxAllocHeap());
+}
+
+static void writeNetwork(MetricsStream& s) {
+    gauge(s, "ethernet_link_up", "Ethernet link state.", ETH.linkUp() ? 1 : 0);
+    counter(s, "ethernet_link_flaps_total", "Ethernet link losses since boot.", ethLinkFlaps);
+    counter(s, "syslog_sent_total", "Log records forwarded to syslog.", getSyslogSentCount());
+    counter(s, "syslog_dropped_total", "Log records dropped by the syslog forwarder.", getSyslogDroppedCount());
+    gauge(s, "syslog_backlog", "Log records waiting for syslog.", getSyslogBacklog());
+}
+
+static void writeUart(MetricsStream& s) {
+    const UARTStats& stats = getUARTStats();
+    family(s, "uart_commands_total", "UART commands by result.", "counter");
+    put(s, METRICS_PREFIX "uart_commands_total{result=\"success\"} %lu\n", stats.successfulCommands);
+    put(s, METRICS_PREFIX "uart_commands_total{result=\"failure\"} %lu\n", stats.failedCommands);
+    gauge(s, "uart_healthy", "UART link health.", isUARTHealthy() ? 1 : 0);
+    gauge(s, "uart_consecutive_errors", "UART errors since the last success.", getUARTErrorCount());
+    gauge(s, "uart_baud_rate", "Configured UART baud rate.", settings.currentBaudRate);
+}
+
+static void writeBackend(MetricsStream& s) {
+    const BackendFrameStats& frames = getBackendFrameStats();
+    gauge(s, "backend_time_valid", "Backend time frames received within the last minute.", isTimeDataValid() ? 1 : 0);
+    family(s, "backend_frames_total", "Backend frames by type.", "counter");
+    put(s, METRICS_PREFIX "backend_frames_total{type=\"date\"} %lu\n", (unsigned long)frames.dateFrames);
+    put(s, METRICS_PREFIX "backend_frames_total{type=\"time\"} %lu\n", (unsigned long)frames.timeFrames);
+    put(s, METRICS_PREFIX "backend_frames_total{type=\"reply\"} %lu\n", (unsigned long)frames.replies);
+    family(s, "backend_frame_errors_total", "Rejected backend frames by reason.", "counter");
+    for (int i = 0; i < FRAME_ERR_COUNT; i++) {
+        put(s, METRICS_PREFIX "backend_frame_errors_total{reason=\"%s\"} %lu\n",
+            frameErrorToString((FrameError)i), (unsigned long)frames.errors[i]);
+    }
+    gauge(s, "clock_synced", "System clock disciplined by a time source.", isClockSynced() ? 1 : 0);
+    family(s, "clock_drift_ppm", "Measured millis() drift.", "gauge");
+    put(s, METRICS_PREFIX "clock_drift_ppm %ld\n", (long)getClockDriftPpm());
+    counter(s, "sntp_success_total", "Successful SNTP rounds.", getSntpSuccessCount());
+    counter(s, "sntp_failure_total", "Failed SNTP rounds.", getSntpFailureCount());
+}
+
+static void writeLogs(MetricsStream& s) {
+    static const LogLevel levels[] = { ERROR, WARN, INFO, DEBUG, SUCCESS };
+    family(s, "log_records_total", "Log records by level since boot.", "counter");
+    for (LogLevel level : levels) {
+        put(s, METRICS_PREFIX "log_records_total{level=\"%s\"} %lu\n", logLevelName(level), (unsigned long)logStoreLevelTotal(level));
+    }
+    gauge(s, "log_store_records", "Records held in the log store.", logStoreCount());
+    gauge(s, "log_stream_clients", "Live log stream subscribers.", getLogStreamClientCount());
+    gauge(s, "live_socket_clients", "WebSocket subscribers.", getLiveSocketClientCount());
+    counter(s, "live_socket_dropped_total", "WebSocket messages skipped for full client queues.", getLiveSocketDroppedCount());
+}
+
+static void writeAuth(MetricsStream& s) {
+    const AuthStats& auth = getAuthStats();
+    gauge(s, "sessions_active", "Open user sessions.", getActiveSessionCount());
+    family(s, "logins_total", "Login attempts by result.", "counter");
+    put(s, METRICS_PREFIX "logins_total{result=\"success\"} %lu\n", (unsigned long)auth.loginSuccess);
+    put(s, METRICS_PREFIX "logins_total{result=\"failure\"} %lu\n", (unsigned long)auth.loginFailure);
+    counter(s, "login_lockouts_total", "Login lockouts after repeated failures.", auth.lockouts);
+    family(s, "sessions_ended_total", "Closed sessions by reason.", "counter");
+    put(s, METRICS_PREFIX "sessions_ended_total{reason=\"logout\"} %lu\n", (unsigned long)auth.logouts);
+    put(s, METRICS_PREFIX "sessions_ended_total{reason=\"timeout\"} %lu\n", (unsigned long)auth.timeouts);
+    put(s, METRICS_PREFIX "sessions_ended_total{reason=\"evicted\"} %lu\n", (unsigned long)auth.evictions);
+}
+
+static void writeHttp(MetricsStream& s) {
+    gauge(s, "http_pool_size", "Connection pool slots.", getHttpPoolSize());
+    gauge(s, "http_active_connections", "Requests holding a pool slot.", getHttpActiveConnections());
+    gauge(s, "http_peak_connections", "Highest concurrent requests since boot.", getHttpPeakConnections());
+    counter(s, "http_rejected_total", "Requests refused with a full pool.", getHttpRejectedCount());
+    counter(s, "http_rate_limited_total", "Requests refused by the per-client rate limit.", getRateLimitedCount());
+    gauge(s, "http_rate_limit_clients", "Clients tracked by the rate limiter.", getRateLimitClientCount());
+    gauge(s, "http_arena_peak_bytes", "Largest JSON arena use of a request.", getHttpArenaPeak());
+    counter(s, "http_arena_overflows_total", "JSON allocations that did not fit the arena.", getHttpArenaOverflows());
+}
+
+// Rota grubunu yazar; grup bittiyse false
+static bool writeRoute(MetricsStream& s) {
+    static const char* classes[] = { "2xx", "3xx", "4xx", "5xx", "aborted" };
+
+    if (s.route < 0) {
+        switch (s.step) {
+            case STEP_ROUTE_RESPONSES:
+                family(s, "http_responses_total", "Responses by route and status class.", "counter");
+                break;
+            case STEP_ROUTE_BYTES:
+                family(s, "http_response_bytes_total", "Response body bytes by route.", "counter");
+                break;
+            case STEP_ROUTE_HANDLER:
+                family(s, "http_handler_seconds_total", "Time from request until the handler queued its response.", "counter");
+                break;
+            default:
+                family(s, "http_request_duration_seconds", "Time from request to connection close.", "histogram");
+                break;
+        }
+        s.route = 0;
+        return true;
+    }
+
+    // Hiç istek almamış rotalar atlanır
+    RouteMetrics m;
+    do {
+        if (s.route >= getRouteMetricsCount()) return false;
+        copyRouteMetrics(s.route++, m);
+    } while (m.count == 0);
+
+    switch (s.step) {
+        case STEP_ROUTE_RESPONSES:
+            for (int i = 0; i < 5; i++) {
+                put(s, METRICS_PREFIX "http_responses_total{method=\"%s\",route=\"%s\",code=\"%s\"} %lu\n",
+                    m.method, m.uri, classes[i], (unsigned long)m.status[i]);
+            }
+            break;
+        case STEP_ROUTE_BYTES:
+            put(s, METRICS_PREFIX "http_response_bytes_total{method=\"%s\",route=\"%s\"} %llu\n",
+                m.method, m.uri, (unsigned long long)m.bytes);
+            break;
+        case STEP_ROUTE_HANDLER:
+            put(s, METRICS_PREFIX "http_handler_seconds_total{method=\"%s\",route=\"%s\"} %llu.%06llu\n",
+                m.method, m.uri, (unsigned long long)(m.handlerTotalUs / 1000000), (unsigned long long)(m.handlerTotalUs % 1000000));
+            break;
+        default: {
+            uint32_t cumulative = 0;
+            for (int b = 0; b < ROUTE_LATENCY_BUCKETS; b++) {
+                cumulative += m.buckets[b];
+                uint16_t limitMs = getRouteBucketLimitMs(b);
+                if (limitMs) {
+                    put(s, METRICS_PREFIX "http_request_duration_seconds_bucket{method=\"%s\",route=\"%s\",le=\"%u.%03u\"} %lu\n",
+                        m.method, m.uri, limitMs / 1000, limitMs % 1000, (unsigned long)cumulative);
+                } else {
+                    put(s, METRICS_PREFIX "http_request_duration_seconds_bucket{method=\"%s\",route=\"%s\",le=\"+Inf\"} %lu\n",
+                        m.method, m.uri, (unsigned long)cumulative);
+                }
+            }
+            put(s, METRICS_PREFIX "http_request_duration_seconds_sum{method=\"%s\",route=\"%s\"} %llu.%06llu\n",
+                m.method, m.uri, (unsigned long long)(m.totalUs / 1000000), (unsigned long long)(m.totalUs % 1000000));
+            put(s, METRICS_PREFIX "http_request_duration_seconds_count{method=\"%s\",route=\"%s\"} %lu\n",
+                m.method, m.uri, (unsigned long)m.count);
+            break;
+        }
+    }
+    return true;
+}
+
+// Sıradaki grubu tampona üretir; çıktı bittiyse false
+static bool produce(MetricsStream& s) {
+    s.len = 0;
+    s.pos = 0;
+    while (s.len == 0) {
+        switch (s.step) {
+            case STEP_SYSTEM:  writeSystem(s);  s.step++; break;
+            case STEP_NETWORK: writeNetwork(s); s.step++; break;
+            case STEP_UART:    writeUart(s);    s.step++; break;
+            case STEP_BACKEND: writeBackend(s); s.step++; break;
+            case STEP_LOGS:    writeLogs(s);    s.step++; break;
+            case STEP_AUTH:    writeAuth(s);    s.step++; break;
+            case STEP_HTTP:    writeHttp(s);    s.step++; break;
+            case STEP_ROUTE_RESPONSES:
+            case STEP_ROUTE_BYTES:
+            case STEP_ROUTE_DURATION:
+            case STEP_ROUTE_HANDLER:
+                if (!writeRoute(s)) {
+                    s.step++;
+                    s.route = -1;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+void handlePrometheusMetrics(AsyncWebServerRequest* request) {
+    HttpSlot* slot = getHttpSlot(request);
+    if (!slot) {
+        request->send(503);
+        return;
+    }
+
+    void* memory = allocateRequestMemory(request, sizeof(MetricsStream));
+    if (!memory) {
+        request->send(503);
+        return;
+    }
+    MetricsStream* stream = new (memory) MetricsStream();
+    stream->slot = slot;
+    AsyncWebServerResponse* response = request->beginChunkedResponse("text/plain; version=0.0.4; charset=utf-8",
+        [stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            MetricsStream& s = *stream;
+            size_t written = 0;
+            while (written < maxLen) {
+                if (s.pos >= s.len && !produce(s)) break;
+                size_t n = s.len - s.pos;
+                if (n > maxLen - written) n = maxLen - written;
+                memcpy(buffer + written, s.slot->buffer + s.pos, n);
+                s.pos += n;
+                written += n;
+            }
+            s.slot->bytes += written;
+            return written;
+        });
+    addSecurityHeaders(response);
+    request->send(response);
+}
@@ -0,0 +1,200 @@
+#include "metrics_history.h"
+#include "uart_handler.h"
+#include "ntp_handler.h"
+#include <ETH.h>
+
+// Üst katmana aktarılacak pencerenin birikimi
+struct HistoryAccumulator {
+    uint16_t count;
+    uint16_t heapKB;
+    uint16_t blockKB;
+    uint32_t loopAvgSum;
+    uint16_t loopMaxMs;
+    uint32_t framesSum;
+    uint32_t uartSum;
+    uint16_t uartCount;         // UART ölçümü olan örnek sayısı
+    uint32_t linkSum;
+};
+
+struct HistoryRing {
+    HistorySample* samples;
+    uint16_t size;
+    uint16_t interval;          // sn
+    uint16_t fanIn;             // Bir üst katman örneği için gereken örnek sayısı
+    uint32_t seq;
+    uint32_t newestUptime;
+    HistoryAccumulator acc;
+};
+
+static HistorySample ring5s[HISTORY_5S_SIZE];
+static HistorySample ring1m[HISTORY_1M_SIZE];
+static HistorySample ring1h[HISTORY_1H_SIZE];
+
+static HistoryRing tiers[HISTORY_TIER_COUNT] = {
+    { ring5s, HISTORY_5S_SIZE, 5, 12, 0, 0, {} },
+    { ring1m, HISTORY_1M_SIZE, 60, 60, 0, 0, {} },
+    { ring1h, HISTORY_1H_SIZE, 3600, 0, 0, 0, {} }
+};
+
+static const char* tierNames[HISTORY_TIER_COUNT] = { "5s", "1m", "1h" };
+static portMUX_TYPE historyMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Döngü süresi (loop() ve web görevi farklı; yalnızca loop() yazar)
+static uint32_t loopSumUs = 0;
+static uint32_t loopCount = 0;
+static uint32_t loopMaxUs = 0;
+
+// Önceki örnekten bu yana farklar için
+static unsigned long lastSampleMillis = 0;
+static unsigned long lastUartTotal = 0;
+static unsigned long lastUartSuccess = 0;
+static uint32_t lastFrames = 0;
+
+void noteLoopTime(uint32_t durationUs) {
+    loopSumUs += durationUs;
+    loopCount++;
+    if (durationUs > loopMaxUs) loopMaxUs = durationUs;
+}
+
+static uint16_t clamp16(uint32_t value) {
+    return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+}
+
+static void accumulate(HistoryAccumulator& acc, const HistorySample& sample) {
+    if (acc.count == 0 || sample.heapKB < acc.heapKB) acc.heapKB = sample.heapKB;
+    if (acc.count == 0 || sample.blockKB < acc.blockKB) acc.blockKB = sample.blockKB;
+    if (sample.loopMaxMs > acc.loopMaxMs) acc.loopMaxMs = sample.loopMaxMs;
+    acc.loopAvgSum += sample.loopAvgUs;
+    acc.framesSum += sample.framesPerMin;
+    if (sample.uartPct != HISTORY_NO_DATA) {
+        acc.uartSum += sample.uartPct;
+        acc.uartCount++;
+    }
+    acc.linkSum += sample.linkPct;
+    acc.count++;
+}
+
+static HistorySample reduce(const HistoryAccumulator& acc) {
+    HistorySample sample;
+    sample.heapKB = acc.heapKB;
+    sample.blockKB = acc.blockKB;
+    sample.loopAvgUs = acc.loopAvgSum / acc.count;
+    sample.loopMaxMs = acc.loopMaxMs;
+    sample.framesPerMin = acc.framesSum / acc.count;
+    sample.uartPct = acc.uartCount ? acc.uartSum / acc.uartCount : HISTORY_NO_DATA;
+    sample.linkPct = acc.linkSum / acc.count;
+    return sample;
+}
+
+// Katmana ekler; pencere dolduysa özet bir üst katmana geçer
+static void insertSample(int tier, const HistorySample& sample, uint32_t uptime) {
+    HistoryRing& ring = tiers[tier];
+
+    portENTER_CRITICAL(&historyMux);
+    ring.samples[ring.seq % ring.size] = sample;
+    ring.seq++;
+    ring.newestUptime = uptime;
+    portEXIT_CRITICAL(&historyMux);
+
+    if (tier + 1 >= HISTORY_TIER_COUNT) return;
+    accumulate(ring.acc, sample);
+    if (ring.acc.count >= ring.fanIn) {
+        HistorySample summary = reduce(ring.acc);
+        memset(&ring.acc, 0, sizeof(ring.acc));
+        insertSample(tier + 1, summary, uptime);
+    }
+}
+
+void sampleMetricsHistory() {
+    unsigned long now = millis();
+    unsigned long elapsed = now - lastSampleMillis;
+    const UARTStats& uart = getUARTStats();
+    const BackendFrameStats& frames = getBackendFrameStats();
+    uint32_t frameTotal = frames.dateFrames + frames.timeFrames;
+
+    // İlk çağrı yalnızca başlangıç değerlerini alır
+    if (lastSampleMillis == 0) {
+        lastSampleMillis = now;
+        lastUartTotal = uart.totalCommands;
+        lastUartSuccess = uart.successfulCommands;
+        lastFrames = frameTotal;
+        return;
+    }
+
+    HistorySample sample;
+    sample.heapKB = ESP.getFreeHeap() / 1024;
+    sample.blockKB = ESP.getMaxAllocHeap() / 1024;
+    sample.loopAvgUs = loopCount ? clamp16(loopSumUs / loopCount) : 0;
+    sample.loopMaxMs = clamp16(loopMaxUs / 1000);
+    sample.framesPerMin = elapsed ? clamp16((uint32_t)((uint64_t)(frameTotal - lastFrames) * 60000 / elapsed)) : 0;
+
+    unsigned long commands = uart.totalCommands - lastUartTotal;
+    sample.uartPct = commands ? (uint8_t)((uart.successfulCommands - lastUartSuccess) * 100 / commands) : HISTORY_NO_DATA;
+    sample.linkPct = ETH.linkUp() ? 100 : 0;
+
+    lastSampleMillis = now;
+    lastUartTotal = uart.totalCommands;
+    lastUartSuccess = uart.successfulCommands;
+    lastFrames = frameTotal;
+    loopSumUs = 0;
+    loopCount = 0;
+    loopMaxUs = 0;
+
+    insertSample(HISTORY_TIER_5S, sample, now / 1000);
+}
+
+bool historyTierFromString(const String& name, HistoryTier& tier) {
+    for (int i = 0; i < HISTORY_TIER_COUNT; i++) {
+        if (name == tierNames[i]) {
+            tier = (HistoryTier)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* historyTierName(HistoryTier tier) {
+    return tierNames[tier];
+}
+
+uint16_t getHistoryInterval(HistoryTier tier) {
+    return tiers[tier].interval;
+}
+
+uint32_t getHistorySeq(HistoryTier tier) {
+    return tiers[tier].seq;
+}
+
+uint32_t getHistoryNewestUptime(HistoryTier tier) {
+    return tiers[tier].newestUptime;
+}
+
+uint16_t getHistorySize(HistoryTier tier) {
+    return tiers[tier].size;
+}
+
+// seq: katmana eklenme sırası (0'dan); halkadan düşmüşse false
+bool getHistorySample(HistoryTier tier, uint32_t seq, HistorySample& out) {
+    HistoryRing& ring = tiers[tier];
+    bool ok;
+    portENTER_CRITICAL(&historyMux);
+    ok = seq < ring.seq && ring.seq - seq <= ring.size;
+    if (ok) out = ring.samples[seq % ring.size];
+    portEXIT_CRITICAL(&historyMux);
+    return ok;
+}
+
+// Grafik için sıkıştırılmış dizi: alan sırası yanıttaki "fields" ile aynı
+void writeHistorySample(const HistorySample& sample, JsonArray out) {
+    out.add(sample.heapKB);
+    out.add(sample.blockKB);
+    out.add(sample.loopAvgUs);
+    out.add(sample.loopMaxMs);
+    if (sample.uartPct == HISTORY_NO_DATA) {
+        out.add(nullptr);
+    } else {
+        out.add(sample.uartPct);
+    }
+    out.add(sample.framesPerMin);
+    out.add(sample.linkPct);
+}
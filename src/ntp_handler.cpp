@@ -1,5 +1,8 @@
 #include "ntp_handler.h"
 #include "log_system.h"
+#include "system_clock.h"
+#include "status_snapshot.h"
+#include "settings.h"
 #include <Preferences.h>
 #include <HardwareSerial.h>
 
@@ -15,6 +18,13 @@ HardwareSerial backendSerial(2);
 #define MAX_DATA_BUFFER 32
 #define MAX_MESSAGE_LENGTH 128
 
+// Ayar gönderimi loop() içinde ilerler; ACK/NACK satırları readBackendData()'dan gelir
+static NTPPushStatus pushStatus = NTP_PUSH_IDLE;
+static bool pushAwaitingAck = false;
+static int pushAttempts = 0;
+static unsigned long pushSentAt = 0;
+static unsigned long pushNextAttemptAt = 0;
+
 bool loadNTPSettings() {
     Preferences preferences;
     preferences.begin("ntp-config", true);
@@ -44,6 +54,7 @@ bool loadNTPSettings() {
     preferences.end();
     
     ntpConfigured = true;
+    statusSetNtpConfigured(ntpConfigured);
     addLog("✅ NTP ayarları NVS'den yüklendi.", SUCCESS, "NTP");
     return true;
 }
@@ -79,50 +90,104 @@ bool isValidIPOrDomain(const String& address) {
     return false;
 }
 
+static void schedulePush(unsigned long delayMs) {
+    pushStatus = NTP_PUSH_PENDING;
+    pushAwaitingAck = false;
+    pushNextAttemptAt = millis() + delayMs;
+}
+
+// Gönderimi sıraya al; asıl iletim ve ACK takibi processNTPPush() içinde
 void sendNTPConfigToBackend() {
     if (strlen(ntpConfig.ntpServer1) == 0) {
         addLog("NTP sunucu adresi boş, arka porta gönderilmiyor.", WARN, "NTP");
         return;
     }
     
-    String message = "NTP_UPDATE;" + String(ntpConfig.ntpServer1) + ";" + String(ntpConfig.ntpServer2);
+    pushAttempts = 0;
+    schedulePush(0);
+}
+
+// "sunucu:port" yalnızca yerel SNTP istemcisi içindir; arka porta port gönderilmez
+static String pushHost(const char* server) {
+    String host(server);
+    int colon = host.indexOf(':');
+    if (colon >= 0) host.remove(colon);
+    return host;
+}
+
+static void transmitPush() {
+    String message = "NTP_UPDATE;" + pushHost(ntpConfig.ntpServer1) + ";" + pushHost(ntpConfig.ntpServer2);
     
     // Mesaj uzunluğu kontrolü
     if (message.length() > MAX_MESSAGE_LENGTH) {
         addLog("NTP ayarı mesajı çok uzun, gönderilemedi.", ERROR, "NTP");
+        pushStatus = NTP_PUSH_IDLE;
         return;
     }
     
     backendSerial.println(message);
-    addLog("Arka porta NTP ayarları gönderildi: " + message, INFO, "NTP");
-
-    // ACK bekleme (geliştirilmiş timeout)
-    unsigned long startTime = millis();
-    String responseBuffer = "";
-    
-    while (millis() - startTime < 3000) { // 3 saniye timeout
-        if (backendSerial.available()) {
-            char c = backendSerial.read();
-            if (c == '\n' || c == '\r') {
-                responseBuffer.trim();
-                if (responseBuffer == "ACK") {
-                    addLog("✅ Arka porttan NTP ayarları için ACK alındı.", SUCCESS, "NTP");
-                    return;
-                } else if (responseBuffer == "NACK") {
-                    addLog("❌ Arka port NTP ayarlarını reddetti.", ERROR, "NTP");
-                    return;
-                }
-                responseBuffer = "";
-            } else {
-                responseBuffer += c;
-                if (responseBuffer.length() > 10) { // Buffer overflow koruması
-                    responseBuffer = "";
-                }
-            }
+    pushAttempts++;
+    pushAwaitingAck = true;
+    pushSentAt = millis();
+    addLog("Arka porta NTP ayarları gönderildi (deneme " + String(pushAttempts) + "): " + message, INFO, "NTP");
+}
+
+// Arka porttan gelen ACK/NACK satırı
+static void handlePushReply(bool ack) {
+    if (!pushAwaitingAck) return;
+    pushAwaitingAck = false;
+    
+    if (ack) {
+        pushStatus = NTP_PUSH_ACKED;
+        addLog("✅ Arka porttan NTP ayarları için ACK alındı.", SUCCESS, "NTP");
+    } else {
+        pushStatus = NTP_PUSH_NACKED;
+        addLog("❌ Arka port NTP ayarlarını reddetti.", ERROR, "NTP");
+    }
+}
+
+void processNTPPush() {
+    if (pushStatus != NTP_PUSH_PENDING) return;
+    
+    if (!pushAwaitingAck) {
+        if ((long)(millis() - pushNextAttemptAt) >= 0) {
+            transmitPush();
         }
-        delay(10);
+        return;
+    }
+    
+    if (millis() - pushSentAt < NTP_PUSH_ACK_TIMEOUT_MS) return;
+    
+    pushAwaitingAck = false;
+    if (pushAttempts >= NTP_PUSH_MAX_ATTEMPTS) {
+        pushStatus = NTP_PUSH_TIMEOUT;
+        addLog("⚠️ Arka porttan ACK alınamadı (" + String(pushAttempts) + " deneme).", WARN, "NTP");
+        return;
+    }
+    
+    // Üstel geri çekilme: 2 s, 4 s, 8 s ...
+    unsigned long backoff = NTP_PUSH_BACKOFF_BASE_MS << (pushAttempts - 1);
+    if (backoff > NTP_PUSH_BACKOFF_MAX_MS) backoff = NTP_PUSH_BACKOFF_MAX_MS;
+    addLog("⚠️ Arka porttan ACK alınamadı, " + String(backoff / 1000) + " sn sonra tekrar denenecek.", WARN, "NTP");
+    schedulePush(backoff);
+}
+
+NTPPushStatus getNTPPushStatus() {
+    return pushStatus;
+}
+
+const char* ntpPushStatusToString(NTPPushStatus status) {
+    switch (status) {
+        case NTP_PUSH_PENDING: return "pending";
+        case NTP_PUSH_ACKED:   return "acked";
+        case NTP_PUSH_NACKED:  return "nacked";
+        case NTP_PUSH_TIMEOUT: return "timeout";
+        default:               return "idle";
     }
-    addLog("⚠️ Arka porttan ACK alınamadı (timeout).", WARN, "NTP");
+}
+
+int getNTPPushAttempts() {
+    return pushAttempts;
 }
 
 bool saveNTPSettings(const String& server1, const String& server2, int timezone) {
@@ -157,8 +222,13 @@ bool saveNTPSettings(const String& server1, const String& server2, int timezone)
     server2.toCharArray(ntpConfig.ntpServer2, sizeof(ntpConfig.ntpServer2));
     ntpConfig.timezone = timezone;
     ntpConfig.enabled = true;
+    // Dilim değişince arka port karelerinden çıkan UTC kayar: saat gerekirse geri de atlayabilir
+    if (timezone != getClockTimezone()) resyncClock();
+    setClockTimezone(timezone);
 
     ntpConfigured = true;
+    statusSetNtpConfigured(ntpConfigured);
+    bumpConfigGeneration(CONFIG_NTP);
     addLog("✅ NTP ayarları kaydedildi: " + server1 + ", " + server2, SUCCESS, "NTP");
     
     // Değişikliği arka porta gönder
@@ -166,69 +236,143 @@ bool saveNTPSettings(const String& server1, const String& server2, int timezone)
     return true;
 }
 
-String formatDate(const String& dateStr) {
-    if (dateStr.length() != 6) return "Geçersiz Tarih";
-    
-    // Tarih geçerliliği kontrolü
-    int day = dateStr.substring(0, 2).toInt();
-    int month = dateStr.substring(2, 4).toInt();
-    int year = 2000 + dateStr.substring(4, 6).toInt();
-    
-    if (day < 1 || day > 31 || month < 1 || month > 12 || year < 2020 || year > 2099) {
-        return "Geçersiz Tarih";
+// Kare çözümleme tabloları: karakter sınıfı ve rakam değeri tek bakışta
+#define CHAR_DIGIT 0x10
+#define CHAR_DATE_MARK 0x20   // 'A'-'Z': tarih karesi
+#define CHAR_TIME_MARK 0x40   // 'a'-'z': saat karesi
+
+static uint8_t frameCharTable[256];
+
+static const uint8_t fieldMin[2][3] = { { 1, 1, 20 }, { 0, 0, 0 } };    // GGAAYY, SSDDss
+static const uint8_t fieldMax[2][3] = { { 31, 12, 99 }, { 23, 59, 59 } };
+static const uint8_t daysInMonth[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static BackendFrameStats frameStats;
+
+static void buildFrameTables() {
+    for (int c = 0; c < 256; c++) {
+        uint8_t cls = 0;
+        if (c >= '0' && c <= '9') cls = CHAR_DIGIT | (c - '0');
+        else if (c >= 'A' && c <= 'Z') cls = CHAR_DATE_MARK;
+        else if (c >= 'a' && c <= 'z') cls = CHAR_TIME_MARK;
+        frameCharTable[c] = cls;
     }
-    
-    return String(day < 10 ? "0" : "") + String(day) + "." + 
-           String(month < 10 ? "0" : "") + String(month) + "." + String(year);
 }
 
-String formatTime(const String& timeStr) {
-    if (timeStr.length() != 6) return "Geçersiz Saat";
-    
-    // Saat geçerliliği kontrolü
-    int hour = timeStr.substring(0, 2).toInt();
-    int minute = timeStr.substring(2, 4).toInt();
-    int second = timeStr.substring(4, 6).toInt();
-    
-    if (hour > 23 || minute > 59 || second > 59) {
-        return "Geçersiz Saat";
+// 7 baytlık kareyi yerinde çöz: 6 rakam + kontrol karakteri. Rakam ve aralık
+// kontrolleri erken çıkış olmadan tüm alanlara uygulanır.
+static bool decodeFrame(const char* frame, size_t length, bool& isTime, uint8_t fields[3], FrameError& error) {
+    if (length != 7) {
+        error = FRAME_ERR_LENGTH;
+        return false;
     }
-    
-    return String(hour < 10 ? "0" : "") + String(hour) + ":" +
-           String(minute < 10 ? "0" : "") + String(minute) + ":" +
-           String(second < 10 ? "0" : "") + String(second);
+
+    uint8_t mark = frameCharTable[(uint8_t)frame[6]] & (CHAR_DATE_MARK | CHAR_TIME_MARK);
+    if (mark == 0) {
+        error = FRAME_ERR_CHECK;
+        return false;
+    }
+    isTime = mark == CHAR_TIME_MARK;
+
+    uint8_t allDigits = CHAR_DIGIT;
+    for (int i = 0; i < 3; i++) {
+        uint8_t hi = frameCharTable[(uint8_t)frame[i * 2]];
+        uint8_t lo = frameCharTable[(uint8_t)frame[i * 2 + 1]];
+        allDigits &= hi & lo;
+        fields[i] = (hi & 0x0F) * 10 + (lo & 0x0F);
+    }
+    if (!allDigits) {
+        error = FRAME_ERR_DIGIT;
+        return false;
+    }
+
+    const uint8_t* minTable = fieldMin[isTime];
+    const uint8_t* maxTable = fieldMax[isTime];
+    bool outOfRange = false;
+    for (int i = 0; i < 3; i++) {
+        outOfRange |= fields[i] < minTable[i] || fields[i] > maxTable[i];
+    }
+    if (!isTime && !outOfRange) {
+        // 2000-2099 arasında 4'e bölünen her yıl artık yıl
+        uint8_t maxDay = daysInMonth[fields[1]] + (fields[1] == 2 && (fields[2] & 3) == 0);
+        outOfRange = fields[0] > maxDay;
+    }
+    if (outOfRange) {
+        error = FRAME_ERR_RANGE;
+        return false;
+    }
+    return true;
 }
 
-void parseTimeData(const String& data) {
-    if (data.length() != 7) {
-        addLog("Arka porttan geçersiz formatta veri: " + data, WARN, "NTP");
-        return;
+// Doğrulanmış tarih ve saat karelerinden sistem saatini düzelt
+static void disciplineFromBackend(unsigned long atMillis) {
+    if (!receivedTime.hasDate) return;
+
+    int64_t localSec = daysFromCivil(2000 + receivedTime.year, receivedTime.month, receivedTime.day) * 86400 +
+                       receivedTime.hour * 3600 + receivedTime.minute * 60 + receivedTime.second;
+    int64_t utcMs = (localSec - (int64_t)ntpConfig.timezone * 3600) * 1000;
+
+    // Gece yarısı saat karesi tarih karesinden önce gelebilir: tarih güncellenene kadar bekle
+    if (isClockSynced()) {
+        int64_t diff = utcMs - (int64_t)getClockMillis();
+        if (diff < -86395000LL && diff > -86405000LL) return;
     }
-    
-    String dataOnly = data.substring(0, 6);
-    char checksum = data.charAt(6);
 
-    // Checksum kontrolü ve veri türü belirleme
-    if (checksum >= 'A' && checksum <= 'Z') { // Tarih verisi
-        String formattedDate = formatDate(dataOnly);
-        if (formattedDate != "Geçersiz Tarih") {
-            receivedTime.date = dataOnly;
-            receivedTime.lastUpdate = millis();
-        }
-    } else if (checksum >= 'a' && checksum <= 'z') { // Saat verisi
-        String formattedTime = formatTime(dataOnly);
-        if (formattedTime != "Geçersiz Saat") {
-            receivedTime.time = dataOnly;
-            receivedTime.isValid = true;
-            receivedTime.lastUpdate = millis();
+    disciplineClock((uint64_t)utcMs, atMillis, CLOCK_SOURCE_BACKEND);
+}
+
+// frame NUL ile sonlanmış olmalı (yalnızca hata logu için)
+void parseTimeData(const char* frame, size_t length) {
+    bool isTime;
+    uint8_t fields[3];
+    FrameError error;
+
+    if (!decodeFrame(frame, length, isTime, fields, error)) {
+        frameStats.errors[error]++;
+        if (error == FRAME_ERR_LENGTH) {
+            addLog("Arka porttan geçersiz formatta veri: " + String(frame), WARN, "NTP");
+        } else if (error == FRAME_ERR_CHECK) {
+            addLog("Bilinmeyen checksum karakteri: " + String(frame[6]), WARN, "NTP");
         }
+        return;
+    }
+
+    if (isTime) {
+        frameStats.timeFrames++;
+        receivedTime.hour = fields[0];
+        receivedTime.minute = fields[1];
+        receivedTime.second = fields[2];
+        receivedTime.isValid = true;
+        receivedTime.lastUpdate = millis();
+        disciplineFromBackend(receivedTime.lastUpdate);
     } else {
-        addLog("Bilinmeyen checksum karakteri: " + String(checksum), WARN, "NTP");
+        frameStats.dateFrames++;
+        receivedTime.day = fields[0];
+        receivedTime.month = fields[1];
+        receivedTime.year = fields[2];
+        receivedTime.hasDate = true;
+        receivedTime.lastUpdate = millis();
+    }
+}
+
+const BackendFrameStats& getBackendFrameStats() {
+    return frameStats;
+}
+
+const char* frameErrorToString(FrameError error) {
+    switch (error) {
+        case FRAME_ERR_LENGTH:   return "length";
+        case FRAME_ERR_DIGIT:    return "digit";
+        case FRAME_ERR_RANGE:    return "range";
+        case FRAME_ERR_CHECK:    return "check";
+        case FRAME_ERR_OVERFLOW: return "overflow";
+        default:                 return "unknown";
     }
 }
 
 void readBackendData() {
-    static String dataBuffer = "";
+    static char dataBuffer[MAX_DATA_BUFFER + 1];
+    static size_t dataLength = 0;
     static unsigned long lastActivity = millis();
     
     while (backendSerial.available()) {
@@ -236,28 +380,36 @@ void readBackendData() {
         lastActivity = millis();
         
         if (c == '\n' || c == '\r') {
-            if (dataBuffer.length() > 0) {
-                parseTimeData(dataBuffer);
-                dataBuffer = "";
+            if (dataLength > 0) {
+                dataBuffer[dataLength] = '\0';
+                if (strcmp(dataBuffer, "ACK") == 0 || strcmp(dataBuffer, "NACK") == 0) {
+                    frameStats.replies++;
+                    handlePushReply(dataBuffer[0] == 'A');
+                } else {
+                    parseTimeData(dataBuffer, dataLength);
+                }
+                dataLength = 0;
             }
         } else {
-            dataBuffer += c;
             // Buffer overflow koruması
-            if (dataBuffer.length() > MAX_DATA_BUFFER) {
+            if (dataLength >= MAX_DATA_BUFFER) {
+                frameStats.errors[FRAME_ERR_OVERFLOW]++;
                 addLog("Backend veri buffer'ı overflow, temizleniyor.", WARN, "NTP");
-                dataBuffer = "";
+                dataLength = 0;
             }
+            dataBuffer[dataLength++] = c;
         }
     }
     
     // Uzun süre veri gelmediğinde buffer'ı temizle
-    if (dataBuffer.length() > 0 && millis() - lastActivity > 5000) {
-        dataBuffer = "";
+    if (dataLength > 0 && millis() - lastActivity > 5000) {
+        dataLength = 0;
     }
 }
 
 void processReceivedData() {
     readBackendData();
+    processNTPPush();
     
     // Veri timeout kontrolü
     if (receivedTime.isValid && (millis() - receivedTime.lastUpdate > 60000)) { // 60 saniye
@@ -269,8 +421,8 @@ void processReceivedData() {
 void initNTPHandler() {
     // Seri port başlatma
     backendSerial.begin(115200, SERIAL_8N1, 4, 2); // RX: 4, TX: 2
-    receivedTime.isValid = false;
-    receivedTime.lastUpdate = 0;
+    buildFrameTables();
+    memset(&receivedTime, 0, sizeof(receivedTime));
     
     // NTP ayarları yükleme
     if (!loadNTPSettings()) {
@@ -281,11 +433,16 @@ void initNTPHandler() {
         ntpConfig.timezone = 3;
         ntpConfig.enabled = true;
         ntpConfigured = false;
+        statusSetNtpConfigured(ntpConfigured);
     }
     
-    // İlk konfigürasyonu gönder
-    delay(1000); // Backend'in hazır olmasını bekle
+    initSystemClock(ntpConfig.timezone);
+    
+    // İlk konfigürasyonu gönder; backend'in hazır olması loop() içinde beklenir
     sendNTPConfigToBackend();
+    if (pushStatus == NTP_PUSH_PENDING) {
+        schedulePush(NTP_PUSH_BOOT_DELAY_MS);
+    }
     
     addLog("✅ NTP Handler başlatıldı.", SUCCESS, "NTP");
 }
@@ -295,19 +452,20 @@ bool isTimeDataValid() {
     return receivedTime.isValid && (millis() - receivedTime.lastUpdate < 60000);
 }
 
+// Düzeltilmiş sistem saatinden, saniyede bir formatlanan önbellek üzerinden
 String getCurrentDateTime() {
-    if (!isTimeDataValid()) return "Zaman verisi bekleniyor...";
-    return formatDate(receivedTime.date) + " " + formatTime(receivedTime.time);
+    char timestamp[LOG_TIMESTAMP_LEN];
+    return getCachedTimestamp(timestamp, sizeof(timestamp)) ? String(timestamp) : String("Zaman verisi bekleniyor...");
 }
 
 String getCurrentDate() {
-    if (!isTimeDataValid()) return "Bilinmiyor";
-    return formatDate(receivedTime.date);
+    char date[LOG_TIMESTAMP_LEN];
+    return getCachedDate(date, sizeof(date)) ? String(date) : String("Bilinmiyor");
 }
 
 String getCurrentTime() {
-    if (!isTimeDataValid()) return "Bilinmiyor";
-    return formatTime(receivedTime.time);
+    char time[LOG_TIMESTAMP_LEN];
+    return getCachedTime(time, sizeof(time)) ? String(time) : String("Bilinmiyor");
 }
 
 // NTP senkronizasyon durumunu kontrol et
@@ -323,6 +481,8 @@ void resetNTPSettings() {
     preferences.end();
     
     ntpConfigured = false;
+    statusSetNtpConfigured(ntpConfigured);
+    bumpConfigGeneration(CONFIG_NTP);
     receivedTime.isValid = false;
     
     addLog("NTP ayarları sıfırlandı.", INFO, "NTP");
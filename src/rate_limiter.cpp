@@ -0,0 +1,89 @@
+#include "rate_limiter.h"
+#include "log_system.h"
+
+// Sabit boyutlu tablo: tablo doluysa en uzun süredir görülmeyen istemci çıkarılır.
+// Tokenlar kesirli dolum için binde bir birimle tutulur.
+struct RateBucket {
+    uint32_t ip;                // 0: boş
+    uint32_t milliTokens;
+    unsigned long lastRefill;
+    unsigned long lastSeen;
+    bool warned;                // Aşım bir kez loglanır
+};
+
+static RateBucket buckets[RATE_TABLE_SIZE];
+static uint32_t limitedCount = 0;
+static portMUX_TYPE rateMux = portMUX_INITIALIZER_UNLOCKED;
+
+static RateBucket* findBucket(uint32_t ip, unsigned long now) {
+    RateBucket* victim = &buckets[0];
+    for (int i = 0; i < RATE_TABLE_SIZE; i++) {
+        if (buckets[i].ip == ip) return &buckets[i];
+        if (buckets[i].ip == 0) {
+            victim = &buckets[i];
+        } else if (victim->ip != 0 && now - buckets[i].lastSeen > now - victim->lastSeen) {
+            victim = &buckets[i];
+        }
+    }
+
+    // Yeni istemci dolu kova ile başlar
+    victim->ip = ip;
+    victim->milliTokens = RATE_BUCKET_CAPACITY * 1000UL;
+    victim->lastRefill = now;
+    victim->warned = false;
+    return victim;
+}
+
+bool rateLimitTake(uint32_t clientIP, uint16_t cost, uint32_t* retryAfterSec) {
+    if (cost == 0) return true;
+
+    unsigned long now = millis();
+    bool allowed;
+    bool logIt = false;
+    uint32_t wait = 0;
+
+    portENTER_CRITICAL(&rateMux);
+    RateBucket* bucket = findBucket(clientIP, now);
+    bucket->lastSeen = now;
+
+    uint32_t elapsed = now - bucket->lastRefill;
+    uint32_t refill = elapsed > RATE_BUCKET_CAPACITY * 1000UL / RATE_REFILL_PER_SEC
+                      ? RATE_BUCKET_CAPACITY * 1000UL
+                      : elapsed * RATE_REFILL_PER_SEC;
+    bucket->milliTokens += refill;
+    if (bucket->milliTokens > RATE_BUCKET_CAPACITY * 1000UL) bucket->milliTokens = RATE_BUCKET_CAPACITY * 1000UL;
+    bucket->lastRefill = now;
+
+    uint32_t need = cost * 1000UL;
+    allowed = bucket->milliTokens >= need;
+    if (allowed) {
+        bucket->milliTokens -= need;
+        bucket->warned = false;
+    } else {
+        limitedCount++;
+        wait = (need - bucket->milliTokens + RATE_REFILL_PER_SEC * 1000UL - 1) / (RATE_REFILL_PER_SEC * 1000UL);
+        logIt = !bucket->warned;
+        bucket->warned = true;
+    }
+    portEXIT_CRITICAL(&rateMux);
+
+    if (!allowed) {
+        if (retryAfterSec) *retryAfterSec = wait > 0 ? wait : 1;
+        if (logIt) {
+            addLog("API istek sınırı aşıldı: " + IPAddress(clientIP).toString(), WARN, "WEB");
+        }
+    }
+    return allowed;
+}
+
+uint32_t getRateLimitedCount() {
+    return limitedCount;
+}
+
+int getRateLimitClientCount() {
+    int count = 0;
+    for (int i = 0; i < RATE_TABLE_SIZE; i++) {
+        if (buckets[i].ip != 0) count++;
+    }
+    return count;
+}
@@ -0,0 +1,168 @@
+#include "route_metrics.h"
+
+// Kayıt yalnızca sayaç artırma ve sabit kova aramasıdır; istek başına birkaç µs.
+
+struct SlowRequest {
+    char uri[ROUTE_SLOWEST_URI_LEN];
+    const char* method;
+    int status;
+    uint32_t durationUs;
+    uint32_t handlerUs;
+    unsigned long uptime;               // sn
+};
+
+// Kova üst sınırları (ms)
+static const uint16_t bucketLimitsMs[ROUTE_LATENCY_BUCKETS - 1] = { 1, 2, 5, 10, 25, 50, 100, 250, 1000 };
+
+static RouteMetrics routes[ROUTE_METRICS_MAX];
+static int routeCount = 0;
+static SlowRequest slowest[ROUTE_SLOWEST_COUNT];
+static uint32_t slowestFloorUs = 0;     // Tablodaki en hızlı isteğin süresi
+static portMUX_TYPE metricsMux = portMUX_INITIALIZER_UNLOCKED;
+
+int registerRouteMetrics(const char* uri, const char* method) {
+    if (routeCount >= ROUTE_METRICS_MAX) return -1;
+    routes[routeCount].uri = uri;
+    routes[routeCount].method = method;
+    return routeCount++;
+}
+
+static int statusClass(int status) {
+    if (status < 200 || status >= 600) return 4;
+    return status / 100 - 2;
+}
+
+static int latencyBucket(uint32_t durationUs) {
+    for (int i = 0; i < ROUTE_LATENCY_BUCKETS - 1; i++) {
+        if (durationUs <= bucketLimitsMs[i] * 1000UL) return i;
+    }
+    return ROUTE_LATENCY_BUCKETS - 1;
+}
+
+// Yeni istek tablodaki en hızlısının yerine geçer (metricsMux tutulurken)
+static void recordSlowRequest(const RouteMetrics& route, const char* uri, int status, uint32_t durationUs, uint32_t handlerUs) {
+    int victim = 0;
+    for (int i = 1; i < ROUTE_SLOWEST_COUNT; i++) {
+        if (slowest[i].durationUs < slowest[victim].durationUs) victim = i;
+    }
+    SlowRequest& slot = slowest[victim];
+    memcpy(slot.uri, uri, sizeof(slot.uri));
+    slot.method = route.method;
+    slot.status = status;
+    slot.durationUs = durationUs;
+    slot.handlerUs = handlerUs;
+    slot.uptime = millis() / 1000;
+
+    slowestFloorUs = slowest[0].durationUs;
+    for (int i = 1; i < ROUTE_SLOWEST_COUNT; i++) {
+        if (slowest[i].durationUs < slowestFloorUs) slowestFloorUs = slowest[i].durationUs;
+    }
+}
+
+void recordRouteRequest(int route, const String& url, int status, uint32_t bytes, uint32_t durationUs, uint32_t handlerUs) {
+    if (route < 0 || route >= routeCount) return;
+    int bucket = latencyBucket(durationUs);
+
+    portENTER_CRITICAL(&metricsMux);
+    RouteMetrics& m = routes[route];
+    m.count++;
+    m.status[statusClass(status)]++;
+    m.bytes += bytes;
+    m.totalUs += durationUs;
+    if (durationUs > m.maxUs) m.maxUs = durationUs;
+    m.handlerTotalUs += handlerUs;
+    if (handlerUs > m.handlerMaxUs) m.handlerMaxUs = handlerUs;
+    m.buckets[bucket]++;
+    bool slow = durationUs > slowestFloorUs;
+    portEXIT_CRITICAL(&metricsMux);
+
+    // Yalnızca tabloya girecek istekler için: URL kritik bölge dışında yerel tampona
+    // alınır, içeride sabit boyutlu kopya yapılır
+    if (slow) {
+        char uri[ROUTE_SLOWEST_URI_LEN];
+        strncpy(uri, url.c_str(), sizeof(uri) - 1);
+        uri[sizeof(uri) - 1] = '\0';
+
+        portENTER_CRITICAL(&metricsMux);
+        recordSlowRequest(m, uri, status, durationUs, handlerUs);
+        portEXIT_CRITICAL(&metricsMux);
+    }
+}
+
+int getRouteMetricsCount() {
+    return routeCount;
+}
+
+void copyRouteMetrics(int route, RouteMetrics& out) {
+    portENTER_CRITICAL(&metricsMux);
+    out = routes[route];
+    portEXIT_CRITICAL(&metricsMux);
+}
+
+uint16_t getRouteBucketLimitMs(int bucket) {
+    return bucket < ROUTE_LATENCY_BUCKETS - 1 ? bucketLimitsMs[bucket] : 0;
+}
+
+// Akış yanıtı öğesi; hiç istek almamış rota boş bırakılır (atlanır)
+bool writeRouteMetricsItem(size_t index, JsonDocument& item) {
+    if ((int)index >= routeCount) return false;
+    RouteMetrics m;
+    copyRouteMetrics(index, m);
+    if (m.count == 0) return true;
+
+    item["method"] = m.method;
+    item["uri"] = m.uri;
+    item["count"] = m.count;
+    JsonObject status = item["status"].to<JsonObject>();
+    status["2xx"] = m.status[0];
+    status["3xx"] = m.status[1];
+    status["4xx"] = m.status[2];
+    status["5xx"] = m.status[3];
+    status["aborted"] = m.status[4];
+    item["bytes"] = m.bytes;
+    item["avgUs"] = (uint32_t)(m.totalUs / m.count);
+    item["maxUs"] = m.maxUs;
+    item["avgHandlerUs"] = (uint32_t)(m.handlerTotalUs / m.count);
+    item["maxHandlerUs"] = m.handlerMaxUs;
+    JsonArray buckets = item["buckets"].to<JsonArray>();
+    for (int b = 0; b < ROUTE_LATENCY_BUCKETS; b++) {
+        buckets.add(m.buckets[b]);
+    }
+    return true;
+}
+
+// Rota listesi dışındaki alanlar: kova sınırları ve en yavaş istekler
+void writeRouteMetrics(JsonDocument& doc) {
+    JsonArray limits = doc["bucketsMs"].to<JsonArray>();
+    for (int i = 0; i < ROUTE_LATENCY_BUCKETS - 1; i++) {
+        limits.add(bucketLimitsMs[i]);
+    }
+
+    portENTER_CRITICAL(&metricsMux);
+    SlowRequest copy[ROUTE_SLOWEST_COUNT];
+    memcpy(copy, slowest, sizeof(copy));
+    portEXIT_CRITICAL(&metricsMux);
+
+    // En yavaştan hızlıya
+    for (int i = 1; i < ROUTE_SLOWEST_COUNT; i++) {
+        SlowRequest key = copy[i];
+        int j = i - 1;
+        while (j >= 0 && copy[j].durationUs < key.durationUs) {
+            copy[j + 1] = copy[j];
+            j--;
+        }
+        copy[j + 1] = key;
+    }
+
+    JsonArray slowList = doc["slowest"].to<JsonArray>();
+    for (int i = 0; i < ROUTE_SLOWEST_COUNT; i++) {
+        if (copy[i].durationUs == 0) continue;
+        JsonObject item = slowList.add<JsonObject>();
+        item["method"] = copy[i].method;
+        item["uri"] = (char*)copy[i].uri;
+        item["status"] = copy[i].status;
+        item["us"] = copy[i].durationUs;
+        item["handlerUs"] = copy[i].handlerUs;
+        item["uptime"] = copy[i].uptime;
+    }
+}
@@ -1,11 +1,29 @@
 #include "settings.h"
 #include "log_system.h"
 #include "crypto_utils.h"
+#include "auth_system.h"
+#include "status_snapshot.h"
 #include <Preferences.h>
 
-WebServer server(80);
+AsyncWebServer server(80);
 Settings settings;
 
+static uint32_t configGeneration[CONFIG_DOMAIN_COUNT];
+static uint32_t bootTag = 0;    // Yeniden başlatmadan sonra eski ETag'ler eşleşmesin
+
+void bumpConfigGeneration(ConfigDomain domain) {
+    configGeneration[domain]++;
+}
+
+uint32_t getConfigGeneration(ConfigDomain domain) {
+    return configGeneration[domain];
+}
+
+void formatConfigETag(ConfigDomain domain, char* out, size_t size) {
+    if (bootTag == 0) bootTag = esp_random() | 1;
+    snprintf(out, size, "\"c%d-%08lx-%lu\"", (int)domain, (unsigned long)bootTag, (unsigned long)configGeneration[domain]);
+}
+
 void loadSettings() {
     Preferences prefs;
     prefs.begin("app-settings", false);
@@ -90,8 +108,6 @@ void loadSettings() {
     prefs.end();
 
     // Session ayarları
-    settings.isLoggedIn = false;
-    settings.sessionStartTime = 0;
     settings.SESSION_TIMEOUT = 1800000; // 30 dakika
 
     addLog("Ayarlar başarıyla yüklendi.", SUCCESS, "SETTINGS");
@@ -149,11 +165,13 @@ bool saveSettings(const String& newDevName, const String& newTmName, const Strin
         
         addLog("Parola güncellendi.", SUCCESS, "SETTINGS");
         
-        // Güvenlik için mevcut oturumu sonlandır
-        settings.isLoggedIn = false;
+        // Güvenlik için tüm oturumları sonlandır
+        endAllSessions();
     }
 
     prefs.end();
+    bumpConfigGeneration(CONFIG_SETTINGS);
+    statusSetDevice(settings.deviceName, settings.transformerStation, settings.local_IP);
     addLog("Cihaz ayarları güncellendi ve kaydedildi.", SUCCESS, "SETTINGS");
     return true;
 }
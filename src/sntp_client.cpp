@@ -0,0 +1,317 @@
+#include "sntp_client.h"
+#include "ntp_handler.h"
+#include "system_clock.h"
+#include "log_system.h"
+#include <WiFiUdp.h>
+#include <ETH.h>
+#include <lwip/dns.h>
+
+// Arka port saat karesi göndermeyi bırakınca yapılandırılmış NTP sunucularına
+// UDP ile sorulur. Her adım loop() içinde bekleme yapmadan ilerler.
+#define NTP_PACKET_SIZE 48
+#define NTP_UNIX_OFFSET 2208988800UL  // 1900 -> 1970
+
+static WiFiUDP sntpUdp;
+static bool udpStarted = false;
+static SntpState state = SNTP_STATE_IDLE;
+static unsigned long nextRoundAt = 0;
+static unsigned long stateStarted = 0;
+
+// Sunucu seçimi: birincil başarısız olursa yedek
+static int serverIndex = 0;
+static char serverHost[64] = "";
+static uint16_t serverPort = SNTP_DEFAULT_PORT;
+static IPAddress serverIP;
+
+// DNS geri çağrısı lwIP görevinden gelir. Her sorgunun tur numarası arg ile taşınır:
+// zaman aşımına uğramış eski sorgunun geç gelen yanıtı sonraki turu tamamlayamaz.
+static bool dnsDone = false;
+static uint32_t dnsResult = 0;
+static uint32_t dnsRound = 0;
+static portMUX_TYPE dnsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Tur içindeki örnekler: UTC - millis() farkı ve gidiş-dönüş süresi
+static int64_t sampleBase[SNTP_SAMPLES];
+static int32_t sampleDelay[SNTP_SAMPLES];
+static int sampleCount = 0;
+static int sentCount = 0;
+static unsigned long requestSentAt = 0;
+static uint8_t requestNonce[8];
+
+static uint32_t successCount = 0;
+static uint32_t failureCount = 0;
+static int32_t lastDelayMs = -1;
+
+static uint32_t readUint32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// NTP zaman damgasından Unix milisaniyesine
+static int64_t ntpToUnixMs(const uint8_t* p) {
+    uint32_t seconds = readUint32(p);
+    uint32_t fraction = readUint32(p + 4);
+    return ((int64_t)seconds - NTP_UNIX_OFFSET) * 1000 + (((uint64_t)fraction * 1000) >> 32);
+}
+
+static void dnsFound(const char* name, const ip_addr_t* ipaddr, void* arg) {
+    portENTER_CRITICAL(&dnsMux);
+    if ((uint32_t)(uintptr_t)arg == dnsRound) {
+        dnsResult = ipaddr ? ip_addr_get_ip4_u32(ipaddr) : 0;
+        dnsDone = true;
+    }
+    portEXIT_CRITICAL(&dnsMux);
+}
+
+// "sunucu" veya yerel test için "sunucu:port"
+static bool selectServer(int index) {
+    const char* configured = index == 0 ? ntpConfig.ntpServer1 : ntpConfig.ntpServer2;
+    if (configured[0] == '\0') return false;
+
+    snprintf(serverHost, sizeof(serverHost), "%s", configured);
+    serverPort = SNTP_DEFAULT_PORT;
+    char* colon = strchr(serverHost, ':');
+    if (colon) {
+        *colon = '\0';
+        int port = atoi(colon + 1);
+        if (port > 0 && port <= 65535) serverPort = port;
+    }
+    return true;
+}
+
+static void finishRound(bool success) {
+    state = SNTP_STATE_WAITING;
+    if (success) {
+        successCount++;
+        nextRoundAt = millis() + SNTP_POLL_INTERVAL_MS;
+        return;
+    }
+
+    failureCount++;
+    // Sıradaki turda diğer sunucuyu dene
+    serverIndex = serverIndex == 0 && ntpConfig.ntpServer2[0] != '\0' ? 1 : 0;
+    nextRoundAt = millis() + SNTP_RETRY_INTERVAL_MS;
+}
+
+static void sendRequest() {
+    uint8_t packet[NTP_PACKET_SIZE];
+    memset(packet, 0, sizeof(packet));
+    packet[0] = 0x23; // LI=0, VN=4, Mode=3 (istemci)
+
+    // Transmit alanına tek seferlik değer; sunucu bunu origin alanında geri döndürür
+    uint32_t now = micros();
+    for (int i = 0; i < 4; i++) {
+        requestNonce[i] = (now >> (24 - i * 8)) & 0xFF;
+        requestNonce[i + 4] = (uint8_t)(sentCount * 31 + i) ^ (uint8_t)esp_random();
+    }
+    memcpy(packet + 40, requestNonce, sizeof(requestNonce));
+
+    // Eski turdan kalan yanıtları at
+    while (sntpUdp.parsePacket() > 0) {
+        sntpUdp.flush();
+    }
+
+    sntpUdp.beginPacket(serverIP, serverPort);
+    sntpUdp.write(packet, sizeof(packet));
+    sntpUdp.endPacket();
+    requestSentAt = millis();
+    sentCount++;
+}
+
+// Yanıtı doğrula ve örnek olarak kaydet
+static bool readReply() {
+    if (sntpUdp.parsePacket() < NTP_PACKET_SIZE) return false;
+    unsigned long receivedAt = millis();
+
+    uint8_t packet[NTP_PACKET_SIZE];
+    if (sntpUdp.read(packet, sizeof(packet)) != NTP_PACKET_SIZE) return false;
+    if ((uint32_t)sntpUdp.remoteIP() != (uint32_t)serverIP) return false;
+
+    uint8_t leap = packet[0] >> 6;
+    uint8_t mode = packet[0] & 0x07;
+    uint8_t stratum = packet[1];
+    if (mode != 4 || leap == 3 || stratum == 0 || stratum > 15) return false;
+    if (memcmp(packet + 24, requestNonce, sizeof(requestNonce)) != 0) return false;
+
+    int64_t serverReceive = ntpToUnixMs(packet + 32);
+    int64_t serverTransmit = ntpToUnixMs(packet + 40);
+    int32_t roundTrip = (int32_t)(receivedAt - requestSentAt) - (int32_t)(serverTransmit - serverReceive);
+    if (roundTrip < 0) roundTrip = 0;
+
+    // Yanıt anındaki UTC: sunucu gönderim zamanı + yolun yarısı
+    sampleBase[sampleCount] = serverTransmit + roundTrip / 2 - (int64_t)receivedAt;
+    sampleDelay[sampleCount] = roundTrip;
+    sampleCount++;
+    return true;
+}
+
+// Örneklerin ortalaması; üç ve üzeri örnekte en gecikmeli olan atılır
+static void applySamples() {
+    int skip = -1;
+    if (sampleCount >= 3) {
+        skip = 0;
+        for (int i = 1; i < sampleCount; i++) {
+            if (sampleDelay[i] > sampleDelay[skip]) skip = i;
+        }
+    }
+
+    int64_t baseSum = 0;
+    int32_t delaySum = 0;
+    int used = 0;
+    for (int i = 0; i < sampleCount; i++) {
+        if (i == skip) continue;
+        baseSum += sampleBase[i];
+        delaySum += sampleDelay[i];
+        used++;
+    }
+
+    unsigned long now = millis();
+    lastDelayMs = delaySum / used;
+    disciplineClock((uint64_t)(baseSum / used + (int64_t)now), now, CLOCK_SOURCE_SNTP);
+}
+
+static void startQuery() {
+    sampleCount = 0;
+    sentCount = 0;
+    state = SNTP_STATE_QUERYING;
+    stateStarted = millis();
+    sendRequest();
+}
+
+static void startRound() {
+    if (!selectServer(serverIndex)) {
+        if (serverIndex != 0 || !selectServer(1)) {
+            finishRound(false);
+            return;
+        }
+        serverIndex = 1;
+    }
+
+    if (!udpStarted) {
+        udpStarted = sntpUdp.begin(SNTP_LOCAL_PORT);
+        if (!udpStarted) {
+            finishRound(false);
+            return;
+        }
+    }
+
+    if (serverIP.fromString(serverHost)) {
+        startQuery();
+        return;
+    }
+
+    // Alan adı: lwIP DNS önbellekte ise hemen, değilse geri çağrı ile döner
+    ip_addr_t resolved;
+    portENTER_CRITICAL(&dnsMux);
+    uint32_t round = ++dnsRound;
+    dnsDone = false;
+    portEXIT_CRITICAL(&dnsMux);
+    err_t err = dns_gethostbyname(serverHost, &resolved, dnsFound, (void*)(uintptr_t)round);
+    if (err == ERR_OK) {
+        serverIP = IPAddress(ip_addr_get_ip4_u32(&resolved));
+        startQuery();
+    } else if (err == ERR_INPROGRESS) {
+        state = SNTP_STATE_RESOLVING;
+        stateStarted = millis();
+    } else {
+        addLog("SNTP sunucusu çözümlenemedi: " + String(serverHost), WARN, "NTP");
+        finishRound(false);
+    }
+}
+
+void processSntpClient() {
+    // Arka port kareleri geliyorsa SNTP devre dışı
+    if (isTimeDataValid() || millis() < SNTP_STARTUP_GRACE_MS || !ntpConfig.enabled) {
+        if (state != SNTP_STATE_IDLE) {
+            state = SNTP_STATE_IDLE;
+            addLog("✅ Arka port saat verisi geri geldi, SNTP yedeği durduruldu.", SUCCESS, "NTP");
+        }
+        return;
+    }
+
+    if (state == SNTP_STATE_IDLE) {
+        addLog("⚠️ Arka port saat verisi yok, SNTP sunucularına geçiliyor.", WARN, "NTP");
+        state = SNTP_STATE_WAITING;
+        serverIndex = 0;
+        nextRoundAt = millis();
+    }
+
+    switch (state) {
+        case SNTP_STATE_WAITING:
+            if ((long)(millis() - nextRoundAt) >= 0 && ETH.linkUp()) {
+                startRound();
+            }
+            break;
+
+        case SNTP_STATE_RESOLVING: {
+            portENTER_CRITICAL(&dnsMux);
+            bool done = dnsDone;
+            uint32_t result = dnsResult;
+            portEXIT_CRITICAL(&dnsMux);
+
+            if (done) {
+                if (result == 0) {
+                    addLog("SNTP sunucusu çözümlenemedi: " + String(serverHost), WARN, "NTP");
+                    finishRound(false);
+                } else {
+                    serverIP = IPAddress(result);
+                    startQuery();
+                }
+            } else if (millis() - stateStarted > SNTP_DNS_TIMEOUT_MS) {
+                finishRound(false);
+            }
+            break;
+        }
+
+        case SNTP_STATE_QUERYING: {
+            bool replied = readReply();
+            bool timedOut = !replied && millis() - requestSentAt > SNTP_REPLY_TIMEOUT_MS;
+            if (!replied && !timedOut) break;
+
+            if (sentCount < SNTP_SAMPLES) {
+                sendRequest();
+                break;
+            }
+
+            if (sampleCount == 0) {
+                addLog("⚠️ SNTP sunucusu yanıt vermedi: " + String(serverHost), WARN, "NTP");
+                finishRound(false);
+            } else {
+                applySamples();
+                finishRound(true);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+bool isSntpActive() {
+    return state != SNTP_STATE_IDLE;
+}
+
+const char* getSntpStateString() {
+    switch (state) {
+        case SNTP_STATE_WAITING:   return "waiting";
+        case SNTP_STATE_RESOLVING: return "resolving";
+        case SNTP_STATE_QUERYING:  return "querying";
+        default:                   return "idle";
+    }
+}
+
+const char* getSntpServer() {
+    return serverHost;
+}
+
+uint32_t getSntpSuccessCount() {
+    return successCount;
+}
+
+uint32_t getSntpFailureCount() {
+    return failureCount;
+}
+
+int32_t getSntpLastDelayMs() {
+    return lastDelayMs;
+}
@@ -0,0 +1,165 @@
+#include "status_snapshot.h"
+#include "log_system.h"
+#include "ntp_handler.h"
+#include "settings.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Gösterge panelinin hazır durumu. Değerler yalnızca değiştiklerinde yazılır ve
+// alanın sürümü artar; /api/status?since=<sürüm> yalnızca yeni alanları döndürür.
+// Durumlar HTML yerine kısa kodlardır, görünüm tarayıcıda oluşturulur.
+struct StatusSnapshot {
+    char datetime[20];
+    uint32_t uptime;                // Saniye
+    char deviceName[52];
+    char tmName[52];
+    char deviceIP[16];
+    uint32_t baudRate;
+    uint32_t freeHeap;
+    const char* chipModel;
+    uint32_t cpuFreq;
+    bool ethernetUp;
+    bool ntpConfigured;
+    bool backendActive;
+};
+
+static StatusSnapshot snapshot;
+static uint32_t fieldVersion[STATUS_FIELD_COUNT];
+static uint32_t version = 0;
+static uint32_t bootVersion = 0;       // Bu açılışın rastgele başlangıç sürümü
+static uint32_t lastTickSecond = UINT32_MAX;
+static SemaphoreHandle_t snapshotMutex = nullptr;
+
+static void lockSnapshot() {
+    if (snapshotMutex) xSemaphoreTake(snapshotMutex, portMAX_DELAY);
+}
+
+static void unlockSnapshot() {
+    if (snapshotMutex) xSemaphoreGive(snapshotMutex);
+}
+
+// Kilit tutulurken çağrılır
+static void touch(StatusField field) {
+    fieldVersion[field] = ++version;
+}
+
+static void setText(StatusField field, char* target, size_t size, const char* value) {
+    if (strncmp(target, value, size - 1) == 0) return;
+    strncpy(target, value, size - 1);
+    target[size - 1] = '\0';
+    touch(field);
+}
+
+static void setNumber(StatusField field, uint32_t& target, uint32_t value) {
+    if (target == value) return;
+    target = value;
+    touch(field);
+}
+
+static void setFlag(StatusField field, bool& target, bool value) {
+    if (target == value) return;
+    target = value;
+    touch(field);
+}
+
+void initStatusSnapshot() {
+    snapshotMutex = xSemaphoreCreateMutex();
+
+    // Sürümler her açılışta rastgele bir tabandan başlar: yeniden başlatmadan önce alınmış
+    // bir sürüm yeni açılışın aralığına düşmez ve istemci kısmi değil tam görüntü alır.
+    // Taban 2^31'in altında; saniyede birkaç artışla taşma onlarca yıl sürer.
+    bootVersion = (esp_random() >> 1) | 1;
+    version = bootVersion;
+
+    // Çalışma süresince değişmeyenler bir kez yazılır
+    lockSnapshot();
+    snapshot.chipModel = ESP.getChipModel();
+    snapshot.cpuFreq = ESP.getCpuFreqMHz();
+    touch(STATUS_FIELD_CHIP_MODEL);
+    touch(STATUS_FIELD_CPU_FREQ);
+    setNumber(STATUS_FIELD_BAUD_RATE, snapshot.baudRate, settings.currentBaudRate);
+    setText(STATUS_FIELD_DEVICE_NAME, snapshot.deviceName, sizeof(snapshot.deviceName), settings.deviceName.c_str());
+    setText(STATUS_FIELD_TM_NAME, snapshot.tmName, sizeof(snapshot.tmName), settings.transformerStation.c_str());
+    setText(STATUS_FIELD_DEVICE_IP, snapshot.deviceIP, sizeof(snapshot.deviceIP), settings.local_IP.toString().c_str());
+    touch(STATUS_FIELD_ETHERNET);
+    touch(STATUS_FIELD_BACKEND);
+    snapshot.ethernetUp = ETH.linkUp();
+    snapshot.ntpConfigured = ntpConfigured;
+    touch(STATUS_FIELD_NTP_CONFIG);
+    unlockSnapshot();
+
+    updateStatusSnapshot();
+}
+
+void updateStatusSnapshot() {
+    uint32_t second = millis() / 1000;
+    if (second == lastTickSecond) return;
+    lastTickSecond = second;
+
+    char datetime[LOG_TIMESTAMP_LEN];
+    if (!getCachedTimestamp(datetime, sizeof(datetime))) datetime[0] = '\0';
+    uint32_t heap = ESP.getFreeHeap();
+
+    lockSnapshot();
+    setText(STATUS_FIELD_DATETIME, snapshot.datetime, sizeof(snapshot.datetime), datetime);
+    setNumber(STATUS_FIELD_UPTIME, snapshot.uptime, second);
+    uint32_t heapDelta = heap > snapshot.freeHeap ? heap - snapshot.freeHeap : snapshot.freeHeap - heap;
+    if (heapDelta >= STATUS_HEAP_STEP) setNumber(STATUS_FIELD_FREE_HEAP, snapshot.freeHeap, heap);
+    setFlag(STATUS_FIELD_BACKEND, snapshot.backendActive, isTimeDataValid());
+    unlockSnapshot();
+}
+
+void statusSetDevice(const String& deviceName, const String& tmName, IPAddress ip) {
+    lockSnapshot();
+    setText(STATUS_FIELD_DEVICE_NAME, snapshot.deviceName, sizeof(snapshot.deviceName), deviceName.c_str());
+    setText(STATUS_FIELD_TM_NAME, snapshot.tmName, sizeof(snapshot.tmName), tmName.c_str());
+    setText(STATUS_FIELD_DEVICE_IP, snapshot.deviceIP, sizeof(snapshot.deviceIP), ip.toString().c_str());
+    unlockSnapshot();
+}
+
+void statusSetBaudRate(long baudRate) {
+    lockSnapshot();
+    setNumber(STATUS_FIELD_BAUD_RATE, snapshot.baudRate, baudRate);
+    unlockSnapshot();
+}
+
+void statusSetEthernet(bool linkUp) {
+    lockSnapshot();
+    setFlag(STATUS_FIELD_ETHERNET, snapshot.ethernetUp, linkUp);
+    unlockSnapshot();
+}
+
+void statusSetNtpConfigured(bool configured) {
+    lockSnapshot();
+    setFlag(STATUS_FIELD_NTP_CONFIG, snapshot.ntpConfigured, configured);
+    unlockSnapshot();
+}
+
+uint32_t getStatusVersion() {
+    return version;
+}
+
+void writeStatusSnapshot(JsonDocument& doc, uint32_t since) {
+    lockSnapshot();
+    // Başka bir açılışa ait sürüm bu açılışın aralığı dışında kalır: tam görüntü
+    if (since <= bootVersion || since > version) since = 0;
+    doc["version"] = version;
+    if (since == 0) doc["full"] = true;
+
+    // char* olarak verilir: ArduinoJson kopyalar, kilit bırakıldıktan sonra değişebilir
+    #define CHANGED(field) (fieldVersion[field] > since)
+    if (CHANGED(STATUS_FIELD_DATETIME)) doc["datetime"] = (char*)snapshot.datetime;
+    if (CHANGED(STATUS_FIELD_UPTIME)) doc["uptime"] = snapshot.uptime;
+    if (CHANGED(STATUS_FIELD_DEVICE_NAME)) doc["deviceName"] = (char*)snapshot.deviceName;
+    if (CHANGED(STATUS_FIELD_TM_NAME)) doc["tmName"] = (char*)snapshot.tmName;
+    if (CHANGED(STATUS_FIELD_DEVICE_IP)) doc["deviceIP"] = (char*)snapshot.deviceIP;
+    if (CHANGED(STATUS_FIELD_BAUD_RATE)) doc["baudRate"] = snapshot.baudRate;
+    if (CHANGED(STATUS_FIELD_FREE_HEAP)) doc["freeHeap"] = snapshot.freeHeap;
+    if (CHANGED(STATUS_FIELD_CHIP_MODEL)) doc["chipModel"] = snapshot.chipModel;
+    if (CHANGED(STATUS_FIELD_CPU_FREQ)) doc["cpuFreq"] = snapshot.cpuFreq;
+    if (CHANGED(STATUS_FIELD_ETHERNET)) doc["ethernet"] = snapshot.ethernetUp ? "up" : "down";
+    if (CHANGED(STATUS_FIELD_NTP_CONFIG)) doc["ntpConfig"] = snapshot.ntpConfigured ? "configured" : "default";
+    if (CHANGED(STATUS_FIELD_BACKEND)) doc["backend"] = snapshot.backendActive ? "active" : "lost";
+    #undef CHANGED
+    unlockSnapshot();
+}
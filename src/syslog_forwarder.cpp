@@ -0,0 +1,202 @@
+#include "syslog_forwarder.h"
+#include "log_store.h"
+#include "log_system.h"
+#include "settings.h"
+#include <Preferences.h>
+#include <WiFiUdp.h>
+#include <time.h>
+
+SyslogConfig syslogConfig;
+
+// Log deposu kuyruk görevi görür: iletici yalnızca kendi imlecini tutar,
+// addLog() ağ ile hiç etkileşmez. Ağ yoksa geride kalan kayıtlar sayılıp atlanır.
+static WiFiUDP syslogUdp;
+static IPAddress collectorIP;
+static char hostName[16] = "-";
+
+static uint32_t cursor = 0;
+static uint32_t cursorEpoch = 0;
+static uint32_t sentCount = 0;
+static uint32_t droppedCount = 0;
+
+static char batch[SYSLOG_MAX_DATAGRAM];
+static size_t batchLen = 0;
+static int batchCount = 0;
+static unsigned long batchStarted = 0;
+
+// Log seviyesinden syslog önem derecesine
+static uint8_t severityFor(uint8_t level) {
+    switch (level) {
+        case ERROR:   return 3; // err
+        case WARN:    return 4; // warning
+        case SUCCESS: return 5; // notice
+        case INFO:    return 6; // info
+        default:      return 7; // debug
+    }
+}
+
+static void flushBatch() {
+    if (batchCount == 0) return;
+
+    bool ok = syslogUdp.beginPacket(collectorIP, syslogConfig.port) &&
+              syslogUdp.write((const uint8_t*)batch, batchLen) == batchLen &&
+              syslogUdp.endPacket();
+    if (ok) {
+        sentCount += batchCount;
+    } else {
+        droppedCount += batchCount;
+    }
+    batchLen = 0;
+    batchCount = 0;
+}
+
+// RFC 5424: <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID [SD] BOM MSG
+static int formatRecord(const LogRecord& rec, char* out, size_t size) {
+    char timestamp[24] = "-";
+    if (rec.wallTime != 0) {
+        time_t t = rec.wallTime;
+        struct tm timeinfo;
+        gmtime_r(&t, &timeinfo);
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
+    }
+
+    const uint8_t facility = 16; // local0
+    int len = snprintf(out, size, "<%u>1 %s %s eklim - %s [meta sequenceId=\"%lu\" sysUpTime=\"%lu\"] \xEF\xBB\xBF%s",
+                       facility * 8 + severityFor(rec.level), timestamp, hostName,
+                       logStoreSourceName(rec.sourceId), (unsigned long)rec.seq,
+                       (unsigned long)rec.uptime * 100, rec.message);
+    if (len < 0) return 0;
+    return len < (int)size ? len : (int)size - 1;
+}
+
+static bool applyConfig() {
+    if (!syslogConfig.enabled) return false;
+    if (!collectorIP.fromString(syslogConfig.host)) {
+        syslogConfig.enabled = false;
+        return false;
+    }
+    snprintf(hostName, sizeof(hostName), "%s", settings.local_IP.toString().c_str());
+    if (hostName[0] == '\0') strcpy(hostName, "-");
+    return true;
+}
+
+void initSyslog() {
+    Preferences prefs;
+    prefs.begin("syslog", true);
+    String host = prefs.getString("host", "");
+    syslogConfig.port = prefs.getUShort("port", SYSLOG_DEFAULT_PORT);
+    syslogConfig.enabled = prefs.getBool("enabled", false);
+    prefs.end();
+
+    host.toCharArray(syslogConfig.host, sizeof(syslogConfig.host));
+
+    // Açılış kayıtları da iletilsin
+    cursor = logStoreOldestSeq() - 1;
+    cursorEpoch = logStoreEpoch();
+
+    if (applyConfig()) {
+        addLog("✅ Syslog iletimi aktif: " + String(syslogConfig.host) + ":" + String(syslogConfig.port), SUCCESS, "SYSLOG");
+    }
+}
+
+bool saveSyslogSettings(const String& host, int port, bool enabled) {
+    IPAddress testIP;
+    if (enabled && !testIP.fromString(host)) {
+        addLog("Geçersiz syslog sunucu adresi: " + host, ERROR, "SYSLOG");
+        return false;
+    }
+    if (port < 1 || port > 65535) {
+        addLog("Geçersiz syslog portu: " + String(port), ERROR, "SYSLOG");
+        return false;
+    }
+
+    Preferences prefs;
+    prefs.begin("syslog", false);
+    prefs.putString("host", host);
+    prefs.putUShort("port", port);
+    prefs.putBool("enabled", enabled);
+    prefs.end();
+
+    flushBatch();
+    host.toCharArray(syslogConfig.host, sizeof(syslogConfig.host));
+    syslogConfig.port = port;
+    syslogConfig.enabled = enabled;
+
+    // Yeni sunucuya yalnızca bundan sonraki kayıtlar gider
+    cursor = logStoreNewestSeq();
+    cursorEpoch = logStoreEpoch();
+
+    if (applyConfig()) {
+        addLog("Syslog ayarları kaydedildi: " + host + ":" + String(port), SUCCESS, "SYSLOG");
+    } else {
+        addLog("Syslog iletimi kapatıldı.", INFO, "SYSLOG");
+    }
+    return true;
+}
+
+void processSyslog() {
+    if (!syslogConfig.enabled) return;
+
+    uint32_t newest = logStoreNewestSeq();
+
+    // Loglar temizlendiyse baştan başla
+    if (cursorEpoch != logStoreEpoch()) {
+        cursorEpoch = logStoreEpoch();
+        cursor = logStoreOldestSeq() - 1;
+    }
+
+    // Sınırlı kuyruk: fazlası atlanır ve sayılır
+    uint32_t oldestAllowed = newest > SYSLOG_MAX_BACKLOG ? newest - SYSLOG_MAX_BACKLOG : 0;
+    if (cursor < oldestAllowed) {
+        droppedCount += oldestAllowed - cursor;
+        cursor = oldestAllowed;
+    }
+
+    if (!ETH.linkUp()) return;
+
+    char line[LOG_STORE_MESSAGE_LEN + 128];
+    logStoreLock();
+    for (int i = 0; i < SYSLOG_RECORDS_PER_LOOP && cursor < newest; i++) {
+        const LogRecord* rec = logStoreGet(cursor + 1);
+        cursor++;
+        if (!rec) {
+            droppedCount++;
+            continue;
+        }
+
+        int len = formatRecord(*rec, line, sizeof(line));
+        // Datagram içinde kayıtlar satır sonu ile ayrılır
+        if (batchLen + len + 1 > sizeof(batch)) {
+            flushBatch();
+        }
+        if (batchCount == 0) {
+            batchStarted = millis();
+        } else {
+            batch[batchLen++] = '\n';
+        }
+        memcpy(batch + batchLen, line, len);
+        batchLen += len;
+        batchCount++;
+
+        if (batchCount >= SYSLOG_BATCH_RECORDS) {
+            flushBatch();
+        }
+    }
+    logStoreUnlock();
+
+    if (batchCount > 0 && millis() - batchStarted >= SYSLOG_FLUSH_MS) {
+        flushBatch();
+    }
+}
+
+uint32_t getSyslogSentCount() {
+    return sentCount;
+}
+
+uint32_t getSyslogDroppedCount() {
+    return droppedCount;
+}
+
+uint32_t getSyslogBacklog() {
+    return logStoreNewestSeq() - cursor;
+}
@@ -0,0 +1,243 @@
+#include "system_clock.h"
+#include "log_system.h"
+#include <sys/time.h>
+
+// millis() üzerinde çalışan, dış referanslarla düzeltilen UTC saat.
+// Zaman okumak yalnızca birkaç tam sayı işlemidir; referans kareleri arasında
+// ölçülen sürüklenme (ppm) ile saniye altı doğruluk korunur.
+// Saat geri gitmez: faz hatası sıçrama yerine geçici hız ayarıyla (slew) eritilir,
+// geri yönde atlama ilk eşitlemede, resyncClock() sonrasında ve referans art arda
+// CLOCK_BACKWARD_CONFIRM_FRAMES kare boyunca aynı farkı gösterdiğinde yapılır.
+static bool synced = false;
+static bool resyncRequested = false;
+static uint64_t baseEpochMs = 0;     // baseMillis anındaki UTC zamanı
+static unsigned long baseMillis = 0;
+static int32_t driftPpm = 0;         // Pozitif: millis() gerçek zamandan yavaş
+static int32_t lastOffsetMs = 0;
+static int32_t slewPpm = 0;          // baseMillis'ten sonraki CLOCK_SLEW_WINDOW_MS boyunca geçerli
+static uint64_t lastReadMs = 0;      // Okumalar bunun altına inmez
+static int backwardFrames = 0;       // Art arda reddedilen geri kareler
+static int64_t backwardOffsetMs = 0; // İlk reddedilen karenin farkı
+static portMUX_TYPE clockMux = portMUX_INITIALIZER_UNLOCKED;
+static int timezoneOffsetSec = 3 * 3600;
+static ClockSource activeSource = CLOCK_SOURCE_NONE;
+static unsigned long lastSyncMillis = 0;
+static unsigned long lastSystemTimeSet = 0;
+
+// Frekans ölçümü için çapa noktası
+static uint64_t anchorRefMs = 0;
+static unsigned long anchorMillis = 0;
+
+// Kilit altında çağrılır. Hız her zaman pozitif olduğundan tahmin artan bir fonksiyondur.
+// Geç işlenen kare tabandan biraz önce ölçülmüş olabilir: farkın üst çeyreği negatif
+// sayılır, geri kalanı işaretsizdir (taban günde bir öne alındığı için yeterli).
+static uint64_t predictAt(unsigned long atMillis) {
+    uint32_t delta = (uint32_t)(atMillis - baseMillis);
+    int64_t elapsed = delta >= 0xC0000000UL ? (int64_t)(int32_t)delta : (int64_t)delta;
+    int64_t slewed = elapsed < (int64_t)CLOCK_SLEW_WINDOW_MS ? elapsed : (int64_t)CLOCK_SLEW_WINDOW_MS;
+    int64_t correction = elapsed * driftPpm / 1000000 + slewed * slewPpm / 1000000;
+    return baseEpochMs + elapsed + correction;
+}
+
+// Kilit altında çağrılır: tahmin sürekliliği bozulmadan yeni taban
+static void rebase(uint64_t epochMs, unsigned long atMillis) {
+    baseEpochMs = epochMs;
+    baseMillis = atMillis;
+}
+
+static void updateSystemTime() {
+    uint64_t nowMs = getClockMillis();
+    struct timeval tv;
+    tv.tv_sec = nowMs / 1000;
+    tv.tv_usec = (nowMs % 1000) * 1000;
+    settimeofday(&tv, nullptr);
+    lastSystemTimeSet = millis();
+}
+
+// Gregoryen tarihten 1970-01-01'e gün sayısı (H. Hinnant algoritması)
+int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = (unsigned)(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int64_t)era * 146097 + (int64_t)doe - 719468;
+}
+
+void initSystemClock(int timezoneHours) {
+    setClockTimezone(timezoneHours);
+}
+
+void setClockTimezone(int timezoneHours) {
+    timezoneOffsetSec = timezoneHours * 3600;
+
+    // libc için POSIX TZ (işaret ters: UTC-3 = UTC+03:00)
+    char tz[16];
+    snprintf(tz, sizeof(tz), "UTC%d", -timezoneHours);
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+void resyncClock() {
+    resyncRequested = true;
+}
+
+void disciplineClock(uint64_t utcMillis, unsigned long atMillis, ClockSource source) {
+    if (!synced || resyncRequested || millis() - lastSyncMillis > CLOCK_HOLDOVER_MS) {
+        // İlk ayar, açık yeniden eşitleme veya uzun kesinti sonrası: iki yöne de atla
+        portENTER_CRITICAL(&clockMux);
+        rebase(utcMillis, atMillis);
+        slewPpm = 0;
+        lastReadMs = 0;
+        portEXIT_CRITICAL(&clockMux);
+        anchorRefMs = utcMillis;
+        anchorMillis = atMillis;
+        lastOffsetMs = 0;
+        backwardFrames = 0;
+        resyncRequested = false;
+        bool first = !synced;
+        synced = true;
+        activeSource = source;
+        lastSyncMillis = millis();
+        updateSystemTime();
+        if (first) {
+            addLog("🕒 Sistem saati ayarlandı (" + String(source == CLOCK_SOURCE_SNTP ? "SNTP" : "arka port") + ").", SUCCESS, "CLOCK");
+        }
+        return;
+    }
+
+    portENTER_CRITICAL(&clockMux);
+    uint64_t predicted = predictAt(atMillis);
+    portEXIT_CRITICAL(&clockMux);
+    int64_t offset = (int64_t)utcMillis - (int64_t)predicted;
+
+    if (offset < -CLOCK_STEP_THRESHOLD_MS) {
+        // Tek kare saati geri alamaz. Reddedilen kareler saati değiştirmediği için gerçek bir
+        // geri sıçramada fark kareden kareye aynı kalır: yeterince tutarlı kare gelince atlanır.
+        if (backwardFrames > 0 && llabs(offset - backwardOffsetMs) <= CLOCK_BACKWARD_AGREE_MS) {
+            backwardFrames++;
+        } else {
+            backwardFrames = 1;
+            backwardOffsetMs = offset;
+            addLog("⚠️ Referans saat " + String((long)-offset) + " ms geride, saat henüz geri alınmadı.", WARN, "CLOCK");
+        }
+        lastOffsetMs = (int32_t)offset;
+        if (backwardFrames < CLOCK_BACKWARD_CONFIRM_FRAMES) return;
+
+        addLog("⚠️ Referans " + String(backwardFrames) + " karedir " + String((long)-offset) + " ms geride, saat geri alındı.", WARN, "CLOCK");
+        portENTER_CRITICAL(&clockMux);
+        rebase(utcMillis, atMillis);
+        slewPpm = 0;
+        lastReadMs = 0;
+        portEXIT_CRITICAL(&clockMux);
+        anchorRefMs = utcMillis;
+        anchorMillis = atMillis;
+        backwardFrames = 0;
+        activeSource = source;
+        lastSyncMillis = millis();
+        updateSystemTime();
+        return;
+    }
+    backwardFrames = 0;
+
+    if (offset > CLOCK_STEP_THRESHOLD_MS) {
+        addLog("⚠️ Saat farkı çok büyük (" + String((long)offset) + " ms), saat ileri atlatıldı.", WARN, "CLOCK");
+        portENTER_CRITICAL(&clockMux);
+        rebase(utcMillis, atMillis);
+        slewPpm = 0;
+        portEXIT_CRITICAL(&clockMux);
+        anchorRefMs = utcMillis;
+        anchorMillis = atMillis;
+        lastOffsetMs = (int32_t)offset;
+        activeSource = source;
+        lastSyncMillis = millis();
+        updateSystemTime();
+        return;
+    }
+
+    // Faz düzeltmesi: hata sonraki pencere boyunca hız ayarıyla eritilir. Her kare
+    // kalan hatayı yeniden ölçtüğü için 1 Hz karelerde etkin kazanç ~1/8 (jitter süzülür).
+    int64_t slew = offset * 1000000 / (int64_t)CLOCK_SLEW_WINDOW_MS;
+    if (slew > CLOCK_MAX_SLEW_PPM) slew = CLOCK_MAX_SLEW_PPM;
+    if (slew < -CLOCK_MAX_SLEW_PPM) slew = -CLOCK_MAX_SLEW_PPM;
+    portENTER_CRITICAL(&clockMux);
+    rebase(predicted, atMillis);
+    slewPpm = (int32_t)slew;
+    portEXIT_CRITICAL(&clockMux);
+    lastOffsetMs = (int32_t)offset;
+    activeSource = source;
+    lastSyncMillis = millis();
+
+    // Frekans düzeltmesi: yeterince uzun pencerede millis() hızını ölç
+    unsigned long window = atMillis - anchorMillis;
+    if (window >= CLOCK_FREQ_WINDOW_MS) {
+        int64_t refElapsed = (int64_t)(utcMillis - anchorRefMs);
+        int64_t measuredPpm = (refElapsed - (int64_t)window) * 1000000 / (int64_t)window;
+        driftPpm += (int32_t)((measuredPpm - driftPpm) / 4);
+        if (driftPpm > CLOCK_MAX_DRIFT_PPM) driftPpm = CLOCK_MAX_DRIFT_PPM;
+        if (driftPpm < -CLOCK_MAX_DRIFT_PPM) driftPpm = -CLOCK_MAX_DRIFT_PPM;
+        anchorRefMs = utcMillis;
+        anchorMillis = atMillis;
+    }
+
+    // libc saatini dakikada bir tazele (log zaman damgaları time() kullanır)
+    if (millis() - lastSystemTimeSet > 60000) {
+        updateSystemTime();
+    }
+}
+
+bool isClockSynced() {
+    return synced && millis() - lastSyncMillis <= CLOCK_HOLDOVER_MS;
+}
+
+// Eşzamanlı okumalar da sıralı kalsın diye son değer kilit altında tutulur
+uint64_t getClockMillis() {
+    portENTER_CRITICAL(&clockMux);
+    unsigned long atMillis = millis();
+    uint64_t now = predictAt(atMillis);
+    uint32_t sinceBase = (uint32_t)(atMillis - baseMillis);
+    if (synced && sinceBase > CLOCK_REBASE_MS && sinceBase < 0xC0000000UL) {
+        // Uzun referanssız süre: tahmin sürekliliği korunarak taban öne alınır (slew çoktan bitti)
+        rebase(now, atMillis);
+        slewPpm = 0;
+    }
+    if (now < lastReadMs) {
+        now = lastReadMs;
+    } else {
+        lastReadMs = now;
+    }
+    portEXIT_CRITICAL(&clockMux);
+    return now;
+}
+
+time_t getClockTime() {
+    return (time_t)(getClockMillis() / 1000);
+}
+
+// Yerel saat: sabit dilim farkı eklenip gmtime ile çözülür (TZ ayrıştırması yok)
+bool getClockLocalTime(struct tm* out) {
+    if (!isClockSynced()) return false;
+    time_t local = getClockTime() + timezoneOffsetSec;
+    gmtime_r(&local, out);
+    return true;
+}
+
+int getClockTimezone() {
+    return timezoneOffsetSec / 3600;
+}
+
+int32_t getClockDriftPpm() {
+    return driftPpm;
+}
+
+int32_t getClockLastOffsetMs() {
+    return lastOffsetMs;
+}
+
+ClockSource getClockSource() {
+    return isClockSynced() ? activeSource : CLOCK_SOURCE_NONE;
+}
+
+unsigned long getClockLastSyncMillis() {
+    return lastSyncMillis;
+}
@@ -1,6 +1,7 @@
 #include "uart_handler.h"
 #include "log_system.h"
 #include "settings.h"
+#include "status_snapshot.h"
 #include <Preferences.h>
 
 #define UART_RX_PIN 4
@@ -59,6 +60,8 @@ bool changeBaudRate(long newBaudRate) {
     // Yeni BaudRate'i ayarla
     long oldBaudRate = settings.currentBaudRate;
     settings.currentBaudRate = newBaudRate;
+    statusSetBaudRate(newBaudRate);
+    bumpConfigGeneration(CONFIG_BAUDRATE);
     
     // Ayarı kalıcı yap
     Preferences prefs;
@@ -194,15 +197,6 @@ String getLastFaultResponse() {
     return lastResponse;
 }
 
-// UART istatistikleri
-struct UARTStats {
-    unsigned long totalCommands;
-    unsigned long successfulCommands;
-    unsigned long failedCommands;
-    unsigned long lastSuccessTime;
-    unsigned long lastFailTime;
-};
-
 static UARTStats uartStats = {0, 0, 0, 0, 0};
 
 // UART istatistiklerini güncelle
@@ -287,4 +281,16 @@ bool testUARTConnection() {
     }
     
     return testResult;
+}
+
+const UARTStats& getUARTStats() {
+    return uartStats;
+}
+
+bool isUARTHealthy() {
+    return uartHealthy;
+}
+
+int getUARTErrorCount() {
+    return uartErrorCount;
 }
\ No newline at end of file
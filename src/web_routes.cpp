@@ -2,191 +2,151 @@
 #include "auth_system.h"
 #include "settings.h"
 #include "ntp_handler.h"
+#include "sntp_client.h"
+#include "system_clock.h"
 #include "uart_handler.h"
 #include "log_system.h"
+#include "log_store.h"
+#include "crash_log.h"
+#include "log_stream.h"
+#include "syslog_forwarder.h"
+#include "embedded_assets.h"
+#include "http_server.h"
+#include "status_snapshot.h"
+#include "live_socket.h"
+#include "route_metrics.h"
+#include "metrics_exporter.h"
+#include "metrics_history.h"
 #include <SPIFFS.h>
-#include <WebServer.h>
 #include <ArduinoJson.h>
 
-extern WebServer server;
 extern Settings settings;
 extern bool ntpConfigured;
 
-// Güvenlik başlıkları ekleyen fonksiyon
-void addSecurityHeaders() {
-    server.sendHeader("X-Content-Type-Options", "nosniff");
-    server.sendHeader("X-Frame-Options", "DENY");
-    server.sendHeader("X-XSS-Protection", "1; mode=block");
-    server.sendHeader("Strict-Transport-Security", "max-age=31536000; includeSubDomains");
-    server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    server.sendHeader("Pragma", "no-cache");
-    server.sendHeader("Expires", "0");
-}
+static const char notFoundPage[] =
+    "<!DOCTYPE html><html><head><title>404 - Sayfa Bulunamadı</title></head>"
+    "<body><h1>404 - Sayfa Bulunamadı</h1><p>İstediğiniz sayfa bulunamadı.</p>"
+    "<a href='/'>Ana Sayfaya Dön</a></body></html>";
+
+// Tek yanıtta döndürülecek en fazla log kaydı
+#define MAX_LOGS_PER_RESPONSE 100
 
-// Rate limiting için basit sistem
-struct RateLimiter {
-    unsigned long lastRequest;
-    int requestCount;
-    static const int MAX_REQUESTS = 10;
-    static const unsigned long TIME_WINDOW = 60000; // 1 dakika
+// Akışla gönderilen log sayfası: sorgu sonucu sıra numaraları
+struct LogPage {
+    uint32_t seqs[MAX_LOGS_PER_RESPONSE];
+    int count;
 };
 
-static RateLimiter apiLimiter = {0, 0};
+const EmbeddedAsset* findEmbeddedAsset(const String& path) {
+    for (size_t i = 0; i < embeddedAssetCount; i++) {
+        if (path == embeddedAssets[i].path) return &embeddedAssets[i];
+    }
+    return nullptr;
+}
 
-bool checkRateLimit() {
-    unsigned long now = millis();
-    
-    // Zaman penceresi sıfırlama
-    if (now - apiLimiter.lastRequest > RateLimiter::TIME_WINDOW) {
-        apiLimiter.requestCount = 0;
-        apiLimiter.lastRequest = now;
+// Flash'taki gzip'li kopyayı doğrudan gönder; gzip desteklemeyen istemci SPIFFS'e düşer
+static bool serveEmbeddedAsset(AsyncWebServerRequest* request, const String& path) {
+    const EmbeddedAsset* asset = findEmbeddedAsset(path);
+    if (!asset || request->header("Accept-Encoding").indexOf("gzip") < 0) return false;
+    
+    AsyncWebServerResponse* response;
+    if (request->header("If-None-Match") == asset->etag) {
+        response = request->beginResponse(304, asset->contentType, "");
+    } else {
+        response = request->beginResponse(200, asset->contentType, asset->data, asset->length);
+        response->addHeader("Content-Encoding", "gzip");
+        countResponseBytes(request, asset->length);
     }
     
-    apiLimiter.requestCount++;
-    
-    if (apiLimiter.requestCount > RateLimiter::MAX_REQUESTS) {
-        addLog("API rate limit aşıldı.", WARN, "WEB");
-        return false;
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Vary", "Accept-Encoding");
+    if (asset->immutable && request->hasArg("v")) {
+        // URL içeriğin özetini taşıyor: içerik değişirse URL de değişir
+        response->addHeader("Cache-Control", "public, max-age=31536000, immutable");
+    } else {
+        response->addHeader("Cache-Control", "private, no-cache");
     }
-    
+    request->send(response);
     return true;
 }
 
-void serveStaticFile(const String& path, const String& contentType) {
-    addSecurityHeaders();
-    
-    if (!SPIFFS.exists(path)) {
-        addLog("Dosya bulunamadı: " + path, WARN, "WEB");
-        server.send(404, "text/html", 
-            "<!DOCTYPE html><html><head><title>404 - Sayfa Bulunamadı</title></head>"
-            "<body><h1>404 - Sayfa Bulunamadı</h1><p>İstediğiniz sayfa bulunamadı.</p>"
-            "<a href='/'>Ana Sayfaya Dön</a></body></html>");
-        return;
-    }
+void serveStaticFile(AsyncWebServerRequest* request, const String& path, const String& contentType) {
+    if (serveEmbeddedAsset(request, path)) return;
     
     File file = SPIFFS.open(path, "r");
     if (!file) {
-        addLog("Dosya açılamadı: " + path, ERROR, "WEB");
-        server.send(500, "text/html",
-            "<!DOCTYPE html><html><head><title>500 - Sunucu Hatası</title></head>"
-            "<body><h1>500 - Sunucu Hatası</h1><p>Dosya okunamadı.</p></body></html>");
-        return;
-    }
-    
-    // Dosya boyutu kontrolü (DoS koruması)
-    size_t fileSize = file.size();
-    if (fileSize > 1048576) { // 1MB limit
-        addLog("Dosya çok büyük: " + path + " (" + String(fileSize) + " bytes)", WARN, "WEB");
-        file.close();
-        server.send(413, "text/plain", "413: Dosya çok büyük");
+        addLog("Dosya bulunamadı: " + path, WARN, "WEB");
+        request->send(404, "text/html", notFoundPage);
+        countResponseBytes(request, sizeof(notFoundPage) - 1);
         return;
     }
-    
-    server.streamFile(file, contentType);
+    countResponseBytes(request, file.size());
     file.close();
-}
-
-String getUptime() {
-    unsigned long totalSeconds = millis() / 1000;
-    unsigned long days = totalSeconds / 86400;
-    unsigned long hours = (totalSeconds % 86400) / 3600;
-    unsigned long minutes = (totalSeconds % 3600) / 60;
-    unsigned long seconds = totalSeconds % 60;
     
-    String uptime = "";
-    if (days > 0) uptime += String(days) + " gün, ";
-    if (hours > 0) uptime += String(hours) + " saat, ";
-    if (minutes > 0) uptime += String(minutes) + " dk, ";
-    uptime += String(seconds) + " sn";
-    
-    return uptime;
+    // Dosya SPIFFS'ten parça parça okunarak gönderilir
+    AsyncWebServerResponse* response = request->beginResponse(SPIFFS, path, contentType);
+    addSecurityHeaders(response);
+    request->send(response);
 }
 
 // Session refresh endpoint
-void handleSessionRefresh() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handleSessionRefresh(AsyncWebServerRequest* request) {
+    if (!refreshSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
-    refreshSession();
-    server.send(200, "application/json", "{\"success\":true}");
+    sendJsonText(request, 200, "{\"success\":true}");
 }
 
 // --- API Handler Fonksiyonları ---
 
-void handleStatusAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handleStatusAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    if (!checkRateLimit()) {
-        server.send(429, "application/json", "{\"error\":\"Çok fazla istek\"}");
+    // Hazır görüntüden yalnızca istemcinin sürümünden sonra değişen alanlar
+    uint32_t since = request->hasArg("since") ? strtoul(request->arg("since").c_str(), nullptr, 10) : 0;
+    if (since > 0 && since == getStatusVersion()) {
+        request->send(304);
         return;
     }
     
-    addSecurityHeaders();
-    
-    JsonDocument doc;
-    doc["datetime"] = getCurrentDateTime();
-    doc["uptime"] = getUptime();
-    doc["deviceName"] = settings.deviceName;
-    doc["tmName"] = settings.transformerStation;
-    doc["deviceIP"] = settings.local_IP.toString();
-    doc["baudRate"] = settings.currentBaudRate;
-    doc["freeHeap"] = ESP.getFreeHeap();
-    doc["chipModel"] = ESP.getChipModel();
-    doc["cpuFreq"] = ESP.getCpuFreqMHz();
-    
-    // Durum göstergeleri
-    doc["ethernetStatus"] = ETH.linkUp() ? 
-        "<span class='status-good'>✅ Bağlı</span>" : 
-        "<span class='status-error'>❌ Bağlantı Yok</span>";
-        
-    doc["ntpConfigStatus"] = ntpConfigured ? 
-        "<span class='status-good'>✅ Yapılandırıldı</span>" : 
-        "<span class='status-warning'>⚠️ Varsayılan</span>";
-        
-    doc["backendStatus"] = isTimeDataValid() ? 
-        "<span class='status-good'>✅ Aktif</span>" : 
-        "<span class='status-error'>❌ Veri Alınamıyor</span>";
-    
-    String jsonOutput;
-    serializeJson(doc, jsonOutput);
-    server.send(200, "application/json", jsonOutput);
+    JsonDocument doc(getJsonAllocator(request));
+    writeStatusSnapshot(doc, since);
+    sendJson(request, 200, doc);
 }
 
-void handleGetSettingsAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handleGetSettingsAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
+    char etag[40];
+    formatConfigETag(CONFIG_SETTINGS, etag, sizeof(etag));
+    if (sendNotModified(request, etag)) return;
     
-    JsonDocument doc;
+    JsonDocument doc(getJsonAllocator(request));
     doc["deviceName"] = settings.deviceName;
     doc["tmName"] = settings.transformerStation;
     doc["username"] = settings.username;
     doc["sessionTimeout"] = settings.SESSION_TIMEOUT / 60000; // dakika cinsinden
     
-    String jsonOutput;
-    serializeJson(doc, jsonOutput);
-    server.send(200, "application/json", jsonOutput);
+    sendJson(request, 200, doc, etag);
 }
 
-void handlePostSettingsAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handlePostSettingsAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
-    
-    String newDevName = server.arg("deviceName");
-    String newTmName = server.arg("tmName");
-    String newUsername = server.arg("username");
-    String newPassword = server.arg("password");
+    String newDevName = request->arg("deviceName");
+    String newTmName = request->arg("tmName");
+    String newUsername = request->arg("username");
+    String newPassword = request->arg("password");
     
     // XSS koruması - basit HTML tag temizleme
     newDevName.replace("<", "&lt;");
@@ -196,99 +156,137 @@ void handlePostSettingsAPI() {
     newUsername.replace("<", "&lt;");
     newUsername.replace(">", "&gt;");
     
-    if (!saveSettings(newDevName, newTmName, newUsername, newPassword)) {
-        server.send(400, "application/json", "{\"error\":\"Ayarlar kaydedilemedi. Girilen değerleri kontrol edin.\"}");
-        return;
-    }
-    
-    server.send(200, "application/json", "{\"success\":true}");
+    // Ayar alanları loop()'a aittir: kayıt orada yapılır
+    deferRequest(request, [newDevName, newTmName, newUsername, newPassword](JsonDocument& doc) {
+        if (!saveSettings(newDevName, newTmName, newUsername, newPassword)) {
+            doc["error"] = "Ayarlar kaydedilemedi. Girilen değerleri kontrol edin.";
+            return 400;
+        }
+        doc["success"] = true;
+        return 200;
+    });
 }
 
-void handleFaultRequest(bool isFirst) {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handleFaultRequest(AsyncWebServerRequest* request, bool isFirst) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    if (!checkRateLimit()) {
-        server.send(429, "application/json", "{\"error\":\"Çok fazla istek\"}");
-        return;
-    }
-    
-    addSecurityHeaders();
-    
-    bool success = isFirst ? requestFirstFault() : requestNextFault();
-    if (success) {
-        String response = getLastFaultResponse();
-        // Response'u JSON için escape et
-        response.replace("\"", "\\\"");
-        response.replace("\n", "\\n");
-        response.replace("\r", "\\r");
-        
-        server.send(200, "application/json", "{\"response\":\"" + response + "\"}");
-        // String concatenation hatası düzeltildi
-        String logMessage = "Arıza bilgisi istendi: ";
-        logMessage += isFirst ? "İlk" : "Sonraki";
-        addLog(logMessage, INFO, "FAULT");
-    } else {
-        server.send(500, "application/json", "{\"error\":\"İşlemciden yanıt alınamadı.\"}");
-        // String concatenation hatası düzeltildi
-        String logMessage = "Arıza bilgisi alınamadı: ";
-        logMessage += isFirst ? "İlk" : "Sonraki";
-        addLog(logMessage, ERROR, "FAULT");
-    }
+    // UART yanıtı 1 sn'ye kadar bekleyebilir: sunucu görevini bloklamamak için loop()'ta
+    deferRequest(request, [isFirst](JsonDocument& doc) {
+        int code;
+        bool success = isFirst ? requestFirstFault() : requestNextFault();
+        if (success) {
+            String response = getLastFaultResponse();
+            doc["response"] = response;
+            publishFaultEvent(response, isFirst);
+            code = 200;
+            // String concatenation hatası düzeltildi
+            String logMessage = "Arıza bilgisi istendi: ";
+            logMessage += isFirst ? "İlk" : "Sonraki";
+            addLog(logMessage, INFO, "FAULT");
+        } else {
+            doc["error"] = "İşlemciden yanıt alınamadı.";
+            code = 500;
+            // String concatenation hatası düzeltildi
+            String logMessage = "Arıza bilgisi alınamadı: ";
+            logMessage += isFirst ? "İlk" : "Sonraki";
+            addLog(logMessage, ERROR, "FAULT");
+        }
+        return code;
+    });
 }
 
-void handleGetNtpAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+// Yalnızca kayıtlı ayarlar: değişmedikçe 304
+void handleGetNtpAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
+    char etag[40];
+    formatConfigETag(CONFIG_NTP, etag, sizeof(etag));
+    if (sendNotModified(request, etag)) return;
     
-    JsonDocument doc;
+    JsonDocument doc(getJsonAllocator(request));
     doc["ntpServer1"] = ntpConfig.ntpServer1;
     doc["ntpServer2"] = ntpConfig.ntpServer2;
     doc["timezone"] = ntpConfig.timezone;
     doc["enabled"] = ntpConfig.enabled;
     doc["configured"] = ntpConfigured;
-    doc["syncStatus"] = isNTPSynced();
     
-    String jsonOutput;
-    serializeJson(doc, jsonOutput);
-    server.send(200, "application/json", jsonOutput);
+    sendJson(request, 200, doc, etag);
 }
 
-void handlePostNtpAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+// Canlı senkron durumu ve sayaçlar (önbelleğe alınmaz)
+void handleGetNtpStatusAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
-    
-    String ntp1 = server.arg("ntpServer1");
-    String ntp2 = server.arg("ntpServer2");
-    int timezone = server.arg("timezone").toInt();
+    JsonDocument doc(getJsonAllocator(request));
+    doc["syncStatus"] = isNTPSynced();
+    doc["pushStatus"] = ntpPushStatusToString(getNTPPushStatus());
+    doc["pushAttempts"] = getNTPPushAttempts();
+    
+    ClockSource source = getClockSource();
+    doc["clockSource"] = source == CLOCK_SOURCE_BACKEND ? "backend" : source == CLOCK_SOURCE_SNTP ? "sntp" : "none";
+    doc["clockDriftPpm"] = getClockDriftPpm();
+    doc["clockOffsetMs"] = getClockLastOffsetMs();
+    
+    JsonObject sntpObj = doc["sntp"].to<JsonObject>();
+    sntpObj["state"] = getSntpStateString();
+    sntpObj["server"] = getSntpServer();
+    sntpObj["success"] = getSntpSuccessCount();
+    sntpObj["failure"] = getSntpFailureCount();
+    sntpObj["delayMs"] = getSntpLastDelayMs();
+    
+    const BackendFrameStats& frames = getBackendFrameStats();
+    JsonObject frameObj = doc["frames"].to<JsonObject>();
+    frameObj["date"] = frames.dateFrames;
+    frameObj["time"] = frames.timeFrames;
+    JsonObject errorObj = frameObj["errors"].to<JsonObject>();
+    for (int i = 0; i < FRAME_ERR_COUNT; i++) {
+        errorObj[frameErrorToString((FrameError)i)] = frames.errors[i];
+    }
     
-    if (!saveNTPSettings(ntp1, ntp2, timezone)) {
-        server.send(400, "application/json", "{\"error\":\"Geçersiz NTP ayarları.\"}");
+    sendJson(request, 200, doc);
+}
+
+void handlePostNtpAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    server.send(200, "application/json", "{\"success\":true}");
+    String ntp1 = request->arg("ntpServer1");
+    String ntp2 = request->arg("ntpServer2");
+    int timezone = request->arg("timezone").toInt();
+    
+    // NTP ayarları, gönderim kuyruğu ve saat dilimi loop()'a aittir
+    deferRequest(request, [ntp1, ntp2, timezone](JsonDocument& doc) {
+        if (!saveNTPSettings(ntp1, ntp2, timezone)) {
+            doc["error"] = "Geçersiz NTP ayarları.";
+            return 400;
+        }
+        doc["success"] = true;
+        return 200;
+    });
 }
 
-void handleGetBaudRateAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handleGetBaudRateAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
+    char etag[40];
+    formatConfigETag(CONFIG_BAUDRATE, etag, sizeof(etag));
+    if (sendNotModified(request, etag)) return;
     
-    JsonDocument doc;
+    JsonDocument doc(getJsonAllocator(request));
     doc["baudRate"] = settings.currentBaudRate;
     
     // ArduinoJson v7 syntax kullanımı - deprecated warning düzeltildi
@@ -302,20 +300,16 @@ void handleGetBaudRateAPI() {
     supportedRates.add(460800);
     supportedRates.add(921600);
     
-    String jsonOutput;
-    serializeJson(doc, jsonOutput);
-    server.send(200, "application/json", jsonOutput);
+    sendJson(request, 200, doc, etag);
 }
 
-void handlePostBaudRateAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handlePostBaudRateAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
-    
-    long newBaud = server.arg("baud").toInt();
+    long newBaud = request->arg("baud").toInt();
     
     // Desteklenen baud rate kontrolü
     const long validRates[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
@@ -328,184 +322,366 @@ void handlePostBaudRateAPI() {
     }
     
     if (!valid) {
-        server.send(400, "application/json", "{\"error\":\"Desteklenmeyen BaudRate değeri.\"}");
+        sendJsonError(request, 400, "Desteklenmeyen BaudRate değeri.");
         return;
     }
     
-    if (!changeBaudRate(newBaud)) {
-        server.send(500, "application/json", "{\"error\":\"BaudRate değiştirilemedi.\"}");
+    // UART yeniden başlatılırken bekleme var: loop()'ta yapılır
+    deferRequest(request, [newBaud](JsonDocument& doc) {
+        if (!changeBaudRate(newBaud)) {
+            doc["error"] = "BaudRate değiştirilemedi.";
+            return 500;
+        }
+        doc["success"] = true;
+        return 200;
+    });
+}
+
+void handleGetLogsAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    server.send(200, "application/json", "{\"success\":true}");
-}
-
-void handleGetLogsAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+    uint32_t newest = logStoreNewestSeq();
+    
+    // İmleç: istemcinin gördüğü son sıra numarası
+    LogQuery query;
+    query.sinceSeq = request->hasArg("since") ? strtoul(request->arg("since").c_str(), nullptr, 10) : 0;
+    if (query.sinceSeq > newest) query.sinceSeq = 0; // Cihaz yeniden başlamış (yeni epoch ile tam liste)
+    
+    // Yeni kayıt yoksa gövde üretmeden dön
+    if (query.sinceSeq > 0 && query.sinceSeq == newest) {
+        request->send(304);
         return;
     }
     
-    addSecurityHeaders();
+    // Sayfalama ve zaman aralığı (uptime saniyesi)
+    query.beforeSeq = strtoul(request->arg("before").c_str(), nullptr, 10);
+    query.fromUptime = strtoul(request->arg("from").c_str(), nullptr, 10);
+    query.toUptime = strtoul(request->arg("to").c_str(), nullptr, 10);
     
-    JsonDocument doc;
-    JsonArray logsArray = doc.to<JsonArray>();
+    query.limit = request->hasArg("limit") ? request->arg("limit").toInt() : 50;
+    if (query.limit < 1 || query.limit > MAX_LOGS_PER_RESPONSE) query.limit = MAX_LOGS_PER_RESPONSE;
     
-    // Logları ters sırada ekle (en yeni önce)
-    for (int i = totalLogs - 1; i >= 0; i--) {
-        int idx = (logIndex - 1 - i + 50) % 50;
-        if (logs[idx].message.length() > 0) {
-            JsonObject logObj = logsArray.add<JsonObject>();
-            logObj["timestamp"] = logs[idx].timestamp;
-            logObj["message"] = logs[idx].message;
-            logObj["level"] = logLevelToString(logs[idx].level);
-            logObj["source"] = logs[idx].source;
-            logObj["millis"] = logs[idx].millis_time;
+    LogLevel levelFilter;
+    query.level = (request->hasArg("level") && logLevelFromString(request->arg("level"), levelFilter)) ? (int)levelFilter : -1;
+    
+    query.sourceId = -1;
+    bool unknownSource = false;
+    if (request->arg("source").length() > 0) {
+        query.sourceId = logStoreFindSource(request->arg("source"));
+        unknownSource = query.sourceId < 0;
+    }
+    
+    // Yalnızca sıra numaraları saklanır (isteğin belge bölgesinde); kayıtlar gönderim sırasında tek tek okunur
+    LogPage* page = (LogPage*)allocateRequestMemory(request, sizeof(LogPage));
+    if (!page) {
+        sendJsonError(request, 500, "Bellek yetersiz");
+        return;
+    }
+    bool more = false;
+    JsonDocument doc(getJsonAllocator(request));
+    
+    logStoreLock();
+    newest = logStoreNewestSeq();
+    page->count = unknownSource ? 0 : logStoreQuery(query, page->seqs, &more);
+    doc["epoch"] = logStoreEpoch();
+    doc["oldest"] = logStoreOldestSeq();
+    doc["capacity"] = logStoreCapacity();
+    logStoreUnlock();
+    
+    if (query.sinceSeq > 0) {
+        // İmleçli okuma: kalan varsa son döndürülen kayıttan devam edilir
+        doc["cursor"] = (more && page->count > 0) ? page->seqs[page->count - 1] : newest;
+        doc["more"] = more;
+    } else {
+        // Sayfa okuma: daha eski kayıtlar before=<next> ile istenir
+        doc["cursor"] = newest;
+        if (more && page->count > 0) {
+            doc["next"] = page->seqs[0];
         }
     }
     
-    String jsonOutput;
-    serializeJson(doc, jsonOutput);
-    server.send(200, "application/json", jsonOutput);
+    sendJsonStream(request, doc, "entries", [page](size_t index, JsonDocument& item) {
+        if (index >= (size_t)page->count) return false;
+        
+        // Gönderim beklerken üzerine yazılan kayıt atlanır
+        logStoreLock();
+        const LogRecord* rec = logStoreGet(page->seqs[index]);
+        if (rec) {
+            char timestamp[LOG_TIMESTAMP_LEN];
+            formatLogTimestamp(rec->wallTime, rec->millis_time, timestamp, sizeof(timestamp));
+            item["seq"] = rec->seq;
+            item["timestamp"] = (char*)timestamp;
+            item["message"] = rec->message;
+            item["level"] = logLevelName((LogLevel)rec->level);
+            item["source"] = logStoreSourceName(rec->sourceId);
+            item["millis"] = rec->millis_time;
+            item["uptime"] = rec->uptime;
+        }
+        logStoreUnlock();
+        return true;
+    });
 }
 
-void handleClearLogsAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handleClearLogsAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
     clearLogs();
-    server.send(200, "application/json", "{\"success\":true}");
+    sendJsonText(request, 200, "{\"success\":true}");
+}
+
+void handleGetSyslogAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    
+    JsonDocument doc(getJsonAllocator(request));
+    doc["host"] = syslogConfig.host;
+    doc["port"] = syslogConfig.port;
+    doc["enabled"] = syslogConfig.enabled;
+    doc["sent"] = getSyslogSentCount();
+    doc["dropped"] = getSyslogDroppedCount();
+    doc["backlog"] = getSyslogBacklog();
+    
+    sendJson(request, 200, doc);
+}
+
+void handlePostSyslogAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    
+    String host = request->arg("host");
+    int port = request->hasArg("port") ? request->arg("port").toInt() : SYSLOG_DEFAULT_PORT;
+    bool enabled = request->arg("enabled") == "true" || request->arg("enabled") == "1";
+    
+    // Syslog gönderici (toplu paket, UDP soketi) loop()'ta çalışır
+    deferRequest(request, [host, port, enabled](JsonDocument& doc) {
+        if (!saveSyslogSettings(host, port, enabled)) {
+            doc["error"] = "Geçersiz syslog ayarları.";
+            return 400;
+        }
+        doc["success"] = true;
+        return 200;
+    });
+}
+
+// Reset öncesi RTC bellekte korunan kayıtlar
+void handleCrashLogAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    
+    JsonDocument doc(getJsonAllocator(request));
+    doc["resetReason"] = getResetReasonString();
+    doc["restartNote"] = getPreviousRestartNote();
+    doc["bootCount"] = getBootCount();
+    
+    sendJsonStream(request, doc, "records", [](size_t index, JsonDocument& item) {
+        if ((int)index >= getCrashLogCount()) return false;
+        const CrashLogRecord* rec = getCrashLogRecord(index);
+        item["millis"] = rec->millis_time;
+        item["level"] = logLevelName((LogLevel)rec->level);
+        item["source"] = rec->source;
+        item["message"] = rec->message;
+        return true;
+    });
 }
 
 // Sistem bilgileri API
-void handleSystemInfoAPI() {
-    if (!checkSession()) {
-        server.send(401, "application/json", "{\"error\":\"Oturum geçersiz\"}");
+void handleSystemInfoAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
         return;
     }
     
-    addSecurityHeaders();
+    // Donanım bilgisi açılışta sabittir
+    char etag[40];
+    formatConfigETag(CONFIG_SYSTEM, etag, sizeof(etag));
+    if (sendNotModified(request, etag)) return;
     
-    JsonDocument doc;
+    JsonDocument doc(getJsonAllocator(request));
     doc["chipModel"] = ESP.getChipModel();
     doc["chipRevision"] = ESP.getChipRevision();
     doc["cpuFreqMHz"] = ESP.getCpuFreqMHz();
-    doc["freeHeap"] = ESP.getFreeHeap();
     doc["totalHeap"] = ESP.getHeapSize();
     doc["flashSize"] = ESP.getFlashChipSize();
     doc["sketchSize"] = ESP.getSketchSize();
     doc["freeSketchSpace"] = ESP.getFreeSketchSpace();
     
-    String jsonOutput;
-    serializeJson(doc, jsonOutput);
-    server.send(200, "application/json", jsonOutput);
+    sendJson(request, 200, doc, etag);
+}
+
+// Anlık bellek durumu (önbelleğe alınmaz)
+void handleSystemMemoryAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    
+    JsonDocument doc(getJsonAllocator(request));
+    doc["freeHeap"] = ESP.getFreeHeap();
+    doc["totalHeap"] = ESP.getHeapSize();
+    doc["maxAllocHeap"] = ESP.getMaxAllocHeap();
+    
+    // Belge bölgesi doluluğu: zirve kapasiteye yaklaşırsa HTTP_ARENA_SIZE büyütülmeli
+    JsonObject arena = doc["jsonArena"].to<JsonObject>();
+    arena["size"] = HTTP_ARENA_SIZE;
+    arena["peak"] = getHttpArenaPeak();
+    arena["overflows"] = getHttpArenaOverflows();
+    
+    sendJson(request, 200, doc);
+}
+
+// Rota başına istek sayıları, gecikme histogramları ve en yavaş istekler.
+// Rota listesi rota sayısıyla büyüdüğü için öğe öğe akışla gönderilir.
+void handleMetricsAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    
+    JsonDocument doc(getJsonAllocator(request));
+    doc["uptime"] = millis() / 1000;
+    writeRouteMetrics(doc);
+    sendJsonStream(request, doc, "routes", writeRouteMetricsItem);
+}
+
+// Sağlık geçmişi; ?tier=5s|1m|1h (varsayılan 1m). Örnekler eskiden yeniye,
+// her biri "fields" sırasıyla değer dizisi. Son örneğin zamanı "newest" (uptime sn).
+void handleMetricsHistoryAPI(AsyncWebServerRequest* request) {
+    if (!checkSession(request)) {
+        sendJsonError(request, 401, "Oturum geçersiz");
+        return;
+    }
+    
+    HistoryTier tier = HISTORY_TIER_1M;
+    if (request->hasArg("tier") && !historyTierFromString(request->arg("tier"), tier)) {
+        sendJsonError(request, 400, "Geçersiz katman (5s, 1m, 1h)");
+        return;
+    }
+    
+    uint32_t seq = getHistorySeq(tier);
+    uint32_t count = seq < getHistorySize(tier) ? seq : getHistorySize(tier);
+    uint32_t first = seq - count;
+    
+    JsonDocument doc(getJsonAllocator(request));
+    doc["tier"] = historyTierName(tier);
+    doc["interval"] = getHistoryInterval(tier);
+    doc["newest"] = getHistoryNewestUptime(tier);
+    doc["uptime"] = millis() / 1000;
+    JsonArray fields = doc["fields"].to<JsonArray>();
+    fields.add("heapKB");
+    fields.add("blockKB");
+    fields.add("loopAvgUs");
+    fields.add("loopMaxMs");
+    fields.add("uartPct");
+    fields.add("framesPerMin");
+    fields.add("linkPct");
+    
+    sendJsonStream(request, doc, "samples", [tier, first, count](size_t index, JsonDocument& item) {
+        if (index >= count) return false;
+        
+        // Gönderim sırasında halkadan düşen örnek boş dizi olur, sıra kaymaz
+        JsonArray values = item.to<JsonArray>();
+        HistorySample sample;
+        if (getHistorySample(tier, first + index, sample)) {
+            writeHistorySample(sample, values);
+        }
+        return true;
+    });
+}
+
+// Oturum gerektiren sayfa: hepsi aynı kabuktan, görünümü adres çubuğundaki yol seçer.
+// Kabuk gzip'li gömülü olduğundan, gzip desteklemeyen istemciye sayfanın kendi dosyası gider.
+static void servePage(AsyncWebServerRequest* request, const char* path) {
+    if (!checkSession(request)) {
+        sendRedirect(request, "/login");
+        return;
+    }
+    if (serveEmbeddedAsset(request, "/app.html")) return;
+    serveStaticFile(request, path, "text/html");
 }
 
 // --- Rota Kurulumu ---
 void setupWebRoutes() {
+    initHttpServer();
+    
     // Ana sayfalar - session kontrolü ile
-    server.on("/", HTTP_GET, []() {
-        if (!checkSession()) { 
-            server.sendHeader("Location", "/login", true); 
-            server.send(302, "text/plain", "Yönlendiriliyor..."); 
-            return; 
-        }
-        serveStaticFile("/index.html", "text/html");
-    });
+    addRoute("/", HTTP_GET, [](AsyncWebServerRequest* request) { servePage(request, "/index.html"); });
     
-    server.on("/login", HTTP_GET, []() { 
+    addRoute("/login", HTTP_GET, [](AsyncWebServerRequest* request) { 
         // Zaten giriş yapmışsa ana sayfaya yönlendir
-        if (checkSession()) {
-            server.sendHeader("Location", "/", true);
-            server.send(302, "text/plain", "Yönlendiriliyor...");
+        if (checkSession(request)) {
+            sendRedirect(request, "/");
             return;
         }
-        serveStaticFile("/login.html", "text/html"); 
+        serveStaticFile(request, "/login.html", "text/html"); 
     });
     
     // Statik dosyalar
-    server.on("/style.css", HTTP_GET, []() { serveStaticFile("/style.css", "text/css"); });
-    server.on("/script.js", HTTP_GET, []() { 
-        addSecurityHeaders();
-        serveStaticFile("/script.js", "application/javascript"); 
-    });
+    addRoute("/style.css", HTTP_GET, [](AsyncWebServerRequest* request) { serveStaticFile(request, "/style.css", "text/css"); }, RATE_COST_FREE);
+    addRoute("/script.js", HTTP_GET, [](AsyncWebServerRequest* request) { serveStaticFile(request, "/script.js", "application/javascript"); }, RATE_COST_FREE);
     
     // Diğer sayfalar - session kontrolü ile
-    server.on("/account", HTTP_GET, []() { 
-        if (!checkSession()) { 
-            server.sendHeader("Location", "/login", true); 
-            server.send(302, "text/plain", ""); 
-            return; 
-        } 
-        serveStaticFile("/account.html", "text/html"); 
-    });
-    
-    server.on("/fault", HTTP_GET, []() { 
-        if (!checkSession()) { 
-            server.sendHeader("Location", "/login", true); 
-            server.send(302, "text/plain", ""); 
-            return; 
-        } 
-        serveStaticFile("/fault.html", "text/html"); 
-    });
-    
-    server.on("/ntp", HTTP_GET, []() { 
-        if (!checkSession()) { 
-            server.sendHeader("Location", "/login", true); 
-            server.send(302, "text/plain", ""); 
-            return; 
-        } 
-        serveStaticFile("/ntp.html", "text/html"); 
-    });
-    
-    server.on("/baudrate", HTTP_GET, []() { 
-        if (!checkSession()) { 
-            server.sendHeader("Location", "/login", true); 
-            server.send(302, "text/plain", ""); 
-            return; 
-        } 
-        serveStaticFile("/baudrate.html", "text/html"); 
-    });
-    
-    server.on("/log", HTTP_GET, []() { 
-        if (!checkSession()) { 
-            server.sendHeader("Location", "/login", true); 
-            server.send(302, "text/plain", ""); 
-            return; 
-        } 
-        serveStaticFile("/log.html", "text/html"); 
-    });
+    addRoute("/account", HTTP_GET, [](AsyncWebServerRequest* request) { servePage(request, "/account.html"); });
+    addRoute("/fault", HTTP_GET, [](AsyncWebServerRequest* request) { servePage(request, "/fault.html"); });
+    addRoute("/ntp", HTTP_GET, [](AsyncWebServerRequest* request) { servePage(request, "/ntp.html"); });
+    addRoute("/baudrate", HTTP_GET, [](AsyncWebServerRequest* request) { servePage(request, "/baudrate.html"); });
+    addRoute("/log", HTTP_GET, [](AsyncWebServerRequest* request) { servePage(request, "/log.html"); });
 
     // Kimlik doğrulama
-    server.on("/login", HTTP_POST, handleUserLogin);
-    server.on("/logout", HTTP_GET, handleUserLogout);
-    
-    // API endpoints
-    server.on("/api/session/refresh", HTTP_POST, handleSessionRefresh);
-    server.on("/api/status", HTTP_GET, handleStatusAPI);
-    server.on("/api/system", HTTP_GET, handleSystemInfoAPI);
-    server.on("/api/settings", HTTP_GET, handleGetSettingsAPI);
-    server.on("/api/settings", HTTP_POST, handlePostSettingsAPI);
-    server.on("/api/faults/first", HTTP_POST, []() { handleFaultRequest(true); });
-    server.on("/api/faults/next", HTTP_POST, []() { handleFaultRequest(false); });
-    server.on("/api/ntp", HTTP_GET, handleGetNtpAPI);
-    server.on("/api/ntp", HTTP_POST, handlePostNtpAPI);
-    server.on("/api/baudrate", HTTP_GET, handleGetBaudRateAPI);
-    server.on("/api/baudrate", HTTP_POST, handlePostBaudRateAPI);
-    server.on("/api/logs", HTTP_GET, handleGetLogsAPI);
-    server.on("/api/logs/clear", HTTP_POST, handleClearLogsAPI);
+    addRoute("/login", HTTP_POST, handleUserLogin, RATE_COST_WRITE);
+    addRoute("/logout", HTTP_GET, handleUserLogout);
+    
+    // Canlı log akışı; "/api/logs" alt yolları da eşlediği için ondan önce kaydedilmeli
+    setupLogStream();
+    addRoute("/api/logs/stream", HTTP_GET, handleLogStreamAPI, RATE_COST_CACHED);
+    
+    // Canlı durum kanalı (WebSocket; zaman, durum, log, arıza ve UART konuları)
+    setupLiveSocket();
+    addRoute("/ws", HTTP_GET, handleLiveSocketAPI, RATE_COST_CACHED);
+    
+    // API endpoints (son parametre: istemcinin token kovasından harcanan miktar)
+    addRoute("/api/session/refresh", HTTP_POST, handleSessionRefresh, RATE_COST_CACHED);
+    addRoute("/api/status", HTTP_GET, handleStatusAPI, RATE_COST_CACHED);
+    addRoute("/api/system/memory", HTTP_GET, handleSystemMemoryAPI, RATE_COST_READ);
+    addRoute("/api/system", HTTP_GET, handleSystemInfoAPI, RATE_COST_READ);
+    addRoute("/api/metrics/history", HTTP_GET, handleMetricsHistoryAPI, RATE_COST_READ);
+    addRoute("/api/metrics", HTTP_GET, handleMetricsAPI, RATE_COST_READ);
+    
+    // Prometheus toplayıcısı oturum açamaz: yalnızca sayaçlar, ayar veya log içeriği yok
+    addRoute("/metrics", HTTP_GET, handlePrometheusMetrics, RATE_COST_READ);
+    addRoute("/api/settings", HTTP_GET, handleGetSettingsAPI, RATE_COST_READ);
+    addRoute("/api/settings", HTTP_POST, handlePostSettingsAPI, RATE_COST_WRITE);
+    addRoute("/api/faults/first", HTTP_POST, [](AsyncWebServerRequest* request) { handleFaultRequest(request, true); }, RATE_COST_UART);
+    addRoute("/api/faults/next", HTTP_POST, [](AsyncWebServerRequest* request) { handleFaultRequest(request, false); }, RATE_COST_UART);
+    addRoute("/api/ntp/status", HTTP_GET, handleGetNtpStatusAPI, RATE_COST_CACHED);
+    addRoute("/api/ntp", HTTP_GET, handleGetNtpAPI, RATE_COST_READ);
+    addRoute("/api/ntp", HTTP_POST, handlePostNtpAPI, RATE_COST_WRITE);
+    addRoute("/api/baudrate", HTTP_GET, handleGetBaudRateAPI, RATE_COST_READ);
+    addRoute("/api/baudrate", HTTP_POST, handlePostBaudRateAPI, RATE_COST_UART);
+    addRoute("/api/logs/clear", HTTP_POST, handleClearLogsAPI, RATE_COST_WRITE);
+    addRoute("/api/logs", HTTP_GET, handleGetLogsAPI, RATE_COST_CACHED);
+    addRoute("/api/crashlog", HTTP_GET, handleCrashLogAPI, RATE_COST_READ);
+    addRoute("/api/syslog", HTTP_GET, handleGetSyslogAPI, RATE_COST_READ);
+    addRoute("/api/syslog", HTTP_POST, handlePostSyslogAPI, RATE_COST_WRITE);
 
     // 404 handler
-    server.onNotFound([]() {
-        addSecurityHeaders();
-        addLog("404 - Bilinmeyen sayfa: " + server.uri(), WARN, "WEB");
-        server.send(404, "text/html", 
-            "<!DOCTYPE html><html><head><title>404 - Sayfa Bulunamadı</title></head>"
-            "<body><h1>404 - Sayfa Bulunamadı</h1><p>İstediğiniz sayfa bulunamadı: " + server.uri() + "</p>"
-            "<a href='/'>Ana Sayfaya Dön</a></body></html>");
+    addNotFoundRoute([](AsyncWebServerRequest* request) {
+        addLog("404 - Bilinmeyen sayfa: " + request->url(), WARN, "WEB");
+        AsyncWebServerResponse* response = request->beginResponse(404, "text/html", notFoundPage);
+        countResponseBytes(request, sizeof(notFoundPage) - 1);
+        addSecurityHeaders(response);
+        request->send(response);
     });
 
     server.begin();
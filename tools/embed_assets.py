@@ -0,0 +1,143 @@
+"""
+Web arayüzü dosyalarını gzip'leyip flash'a gömülecek C++ tablosuna çevirir.
+
+PlatformIO derlemesinden önce çalışır (platformio.ini: extra_scripts = pre:...).
+Elle de çalıştırılabilir:  python tools/embed_assets.py
+
+- Her dosya sabit zaman damgasıyla gzip'lenir (aynı içerik -> aynı çıktı)
+- ETag, gzip'li içeriğin SHA-256 özetinden üretilir
+- HTML içindeki style.css / script.js bağlantılarına ?v=<özet> eklenir;
+  böylece bu dosyalar tarayıcıda süresiz (immutable) önbelleğe alınabilir
+- Oturumlu sayfalar tek bir kabukta (/app.html) birleştirilir: gezinme çubuğu
+  bir kez, her sayfanın içeriği <template data-view="..."> olarak. Görünüm
+  geçişini script.js yapar; sayfa değiştirmek sunucuya istek göndermez.
+  Ayrı HTML dosyaları yalnızca gzip desteklemeyen istemciler için SPIFFS'te kalır.
+"""
+
+import gzip
+import hashlib
+import os
+
+ASSETS = [
+    # (dosya, URL yolu, içerik türü)
+    ("style.css", "/style.css", "text/css"),
+    ("script.js", "/script.js", "application/javascript"),
+    ("login.html", "/login.html", "text/html"),
+]
+
+# Kabuktaki görünümler (dosya, görünüm yolu); gezinme çubuğu ilk dosyadan alınır
+VIEWS = [
+    ("index.html", "/"),
+    ("ntp.html", "/ntp"),
+    ("baudrate.html", "/baudrate"),
+    ("fault.html", "/fault"),
+    ("account.html", "/account"),
+    ("log.html", "/log"),
+]
+
+SHELL = ("app.html", "/app.html", "text/html")
+
+# Sürümlenen (immutable) dosyalar; HTML her zaman yeniden doğrulanır
+VERSIONED = ("style.css", "script.js")
+
+OUTPUT = os.path.join("src", "embedded_assets_data.cpp")
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def c_array(data):
+    lines = []
+    for i in range(0, len(data), 20):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 20]) + ",")
+    return "\n".join(lines)
+
+
+def view_title(html):
+    return html[html.index(b"<title>") + len(b"<title>"):html.index(b"</title>")]
+
+
+def build_shell(sources):
+    """Sayfaların </nav> ile <script> arasındaki içeriğinden şablonlu kabuk."""
+    first = sources[VIEWS[0][0]]
+    nav_end = first.index(b"</nav>") + len(b"</nav>")
+    script_start = first.index(b"<script src=")
+
+    parts = [first[:nav_end], b'\n\n    <main id="view-root"></main>\n']
+    for name, path in VIEWS:
+        html = sources[name]
+        body = html[html.index(b"</nav>") + len(b"</nav>"):html.index(b"<script src=")]
+        parts.append(b'\n    <template data-view="%s" data-title="%s">' % (path.encode(), view_title(html)))
+        parts.append(body.rstrip() + b"\n    </template>\n")
+    parts.append(b"\n    " + first[script_start:])
+    return b"".join(parts)
+
+
+def build(project_dir):
+    data_dir = os.path.join(project_dir, "data")
+    sources = {}
+    for name in [a[0] for a in ASSETS] + [v[0] for v in VIEWS]:
+        with open(os.path.join(data_dir, name), "rb") as f:
+            sources[name] = f.read()
+
+    # Önce sürümlenen dosyaların özetleri, sonra HTML içindeki bağlantılar
+    versions = {name: content_hash(sources[name]) for name in VERSIONED}
+    for name in sources:
+        if not name.endswith(".html"):
+            continue
+        html = sources[name]
+        for asset, version in versions.items():
+            for quote in (b'"', b"'"):
+                for prefix in (b"", b"/"):
+                    old = quote + prefix + asset.encode() + quote
+                    new = quote + b"/" + asset.encode() + b"?v=" + version.encode() + quote
+                    html = html.replace(old, new)
+        sources[name] = html
+
+    sources[SHELL[0]] = build_shell(sources)
+    assets = ASSETS + [SHELL]
+
+    out = []
+    out.append("// Bu dosya tools/embed_assets.py tarafından üretilir, elle düzenlemeyin.")
+    out.append('#include "embedded_assets.h"')
+    out.append("")
+    table = []
+    for index, (name, path, content_type) in enumerate(assets):
+        compressed = gzip.compress(sources[name], compresslevel=9, mtime=0)
+        etag = '"%s"' % content_hash(compressed)
+        symbol = "asset_%d" % index
+        out.append("// %s: %d -> %d bayt" % (name, len(sources[name]), len(compressed)))
+        out.append("static const uint8_t %s[] = {" % symbol)
+        out.append(c_array(compressed))
+        out.append("};")
+        out.append("")
+        table.append('    { "%s", "%s", %s, sizeof(%s), "%s", %s },' % (
+            path, content_type, symbol, symbol, etag.replace('"', '\\"'),
+            "true" if name in VERSIONED else "false"))
+
+    out.append("const EmbeddedAsset embeddedAssets[] = {")
+    out.extend(table)
+    out.append("};")
+    out.append("")
+    out.append("const size_t embeddedAssetCount = sizeof(embeddedAssets) / sizeof(embeddedAssets[0]);")
+    out.append("")
+    text = "\n".join(out)
+
+    # İçerik değişmediyse dosyaya dokunma (gereksiz yeniden derlemeyi önler)
+    output_path = os.path.join(project_dir, OUTPUT)
+    if os.path.exists(output_path):
+        with open(output_path, "r", encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    with open(output_path, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    print("embed_assets: %s güncellendi" % OUTPUT)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO/SCons ortamı
+    build(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))